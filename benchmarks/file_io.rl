@@ -0,0 +1,16 @@
+# benchmarks/file_io.rl
+# Writing a file record by record and streaming it back. Reference: benchmarks/reference/file_io.cpp
+# Run with: python3 redline.py bench-suite file_io
+
+@bench
+def write_read_lines() -> int:
+    val path: string = "redline_bench_io.txt"
+    val out: writer = open_write(path)
+    for i in 0..20000:
+        out.write_line("record," + to_string(i + len(args)))
+    out.close()
+    var total: int = 0
+    for line in lines(path):
+        total = total + len(line)
+    remove(path)
+    return total
@@ -0,0 +1,12 @@
+# benchmarks/formatting.rl
+# Building strings with f-strings. Reference: benchmarks/reference/formatting.cpp
+# Run with: python3 redline.py bench-suite formatting
+
+@bench
+def fstrings() -> int:
+    val name: string = "user" + to_string(len(args))
+    var total: int = 0
+    for i in 0..10000:
+        val line: string = f"id={i} name={name} score={i * 0.25} active={i > 5000}"
+        total = total + len(line)
+    return total
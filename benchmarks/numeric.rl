@@ -0,0 +1,27 @@
+# benchmarks/numeric.rl
+# Loops over numeric lists. Reference: benchmarks/reference/numeric.cpp
+# Run with: python3 redline.py bench-suite numeric
+
+def make_floats(n: int) -> list[float]:
+    var xs: list[float] = list[float](n)
+    for i in 0..n:
+        append(xs, (i + len(args)) * 0.5)
+    return xs
+
+@bench
+def sum_of_squares() -> float:
+    val xs: list[float] = make_floats(100000)
+    var total: float = 0.0
+    for i in 0..len(xs):
+        total = total + xs[i] * xs[i]
+    return total
+
+# Running sums, written back in place.
+@bench
+def prefix_sums() -> int:
+    var xs: list[int] = list[int](100000)
+    for i in 0..100000:
+        append(xs, i + len(args))
+    for i in 1..len(xs):
+        xs[i] = xs[i] + xs[i - 1]
+    return xs[99999]
@@ -0,0 +1,48 @@
+# benchmarks/objects.rl
+# Allocating objects with `new` in a loop. Reference: benchmarks/reference/objects.cpp
+# Run with: python3 redline.py bench-suite objects
+
+class Particle:
+    var x: float = 0.0
+    var y: float = 0.0
+    var vx: float = 0.0
+    var vy: float = 0.0
+
+    def init(px: float, py: float):
+        this.x = px
+        this.y = py
+        this.vx = py * 0.01
+        this.vy = px * 0.01
+
+    def step():
+        this.x = this.x + this.vx
+        this.y = this.y + this.vy
+
+struct Point:
+    var x: float = 0.0
+    var y: float = 0.0
+
+    def init(px: float, py: float):
+        this.x = px
+        this.y = py
+
+# Reference-counted heap objects: one allocation each.
+@bench
+def new_classes() -> float:
+    var particles: list[Particle] = list[Particle](10000)
+    for i in 0..10000:
+        append(particles, new Particle(i * 1.0, len(args) * 1.0))
+    for p in particles:
+        p.step()
+    return particles[9999].x
+
+# Value structs: stored inline in the list, no allocation per element.
+@bench
+def new_structs() -> float:
+    var points: list[Point] = list[Point](10000)
+    for i in 0..10000:
+        append(points, new Point(i * 1.0, len(args) * 1.0))
+    var total: float = 0.0
+    for p in points:
+        total = total + p.x + p.y
+    return total
@@ -0,0 +1,38 @@
+// benchmarks/reference/file_io.cpp
+// Hand-written C++ for benchmarks/file_io.rl, timed by the same harness.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+static int write_read_lines() {
+    const char* path = "redline_bench_io.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (int i = 0; i < 20000; ++i) {
+            out << "record," << (i + arg_count) << '\n';
+        }
+    }
+    int total = 0;
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line)) {
+            total += static_cast<int>(line.size());
+        }
+    }
+    std::remove(path);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("write_read_lines", write_read_lines),
+    }, args);
+}
@@ -0,0 +1,29 @@
+// benchmarks/reference/formatting.cpp
+// Hand-written C++ for benchmarks/formatting.rl, timed by the same harness.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+static int fstrings() {
+    std::string name = "user" + std::to_string(arg_count);
+    int total = 0;
+    char line[128];
+    for (int i = 0; i < 10000; ++i) {
+        int length = std::snprintf(line, sizeof line, "id=%d name=%s score=%g active=%s",
+            i, name.c_str(), i * 0.25, i > 5000 ? "true" : "false");
+        total += length;
+    }
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("fstrings", fstrings),
+    }, args);
+}
@@ -0,0 +1,47 @@
+// benchmarks/reference/numeric.cpp
+// Hand-written C++ for benchmarks/numeric.rl, timed by the same harness.
+#include <string>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+static std::vector<double> make_floats(int n) {
+    std::vector<double> xs;
+    xs.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        xs.push_back((i + arg_count) * 0.5);
+    }
+    return xs;
+}
+
+static double sum_of_squares() {
+    std::vector<double> xs = make_floats(100000);
+    double total = 0.0;
+    for (double x : xs) {
+        total += x * x;
+    }
+    return total;
+}
+
+static int prefix_sums() {
+    std::vector<int> xs;
+    xs.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        xs.push_back(i + arg_count);
+    }
+    for (std::size_t i = 1; i < xs.size(); ++i) {
+        xs[i] += xs[i - 1];
+    }
+    return xs[99999];
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("sum_of_squares", sum_of_squares),
+        rl::bench_case("prefix_sums", prefix_sums),
+    }, args);
+}
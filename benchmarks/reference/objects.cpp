@@ -0,0 +1,59 @@
+// benchmarks/reference/objects.cpp
+// Hand-written C++ for benchmarks/objects.rl, timed by the same harness. Both
+// kernels use plain values, as C++ code would: new_classes shows what the
+// reference counting of REDLINE classes costs over that.
+#include <string>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+struct Particle {
+    double x, y, vx, vy;
+
+    Particle(double px, double py) : x(px), y(py), vx(py * 0.01), vy(px * 0.01) {}
+
+    void step() {
+        x += vx;
+        y += vy;
+    }
+};
+
+struct Point {
+    double x, y;
+};
+
+static double new_classes() {
+    std::vector<Particle> particles;
+    particles.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        particles.emplace_back(i * 1.0, arg_count * 1.0);
+    }
+    for (Particle& p : particles) {
+        p.step();
+    }
+    return particles[9999].x;
+}
+
+static double new_structs() {
+    std::vector<Point> points;
+    points.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        points.push_back({ i * 1.0, arg_count * 1.0 });
+    }
+    double total = 0.0;
+    for (const Point& p : points) {
+        total += p.x + p.y;
+    }
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("new_classes", new_classes),
+        rl::bench_case("new_structs", new_structs),
+    }, args);
+}
@@ -0,0 +1,70 @@
+// benchmarks/reference/strings.cpp
+// Hand-written C++ for benchmarks/strings.rl, timed by the same harness.
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+static std::string make_line(int fields) {
+    std::string line;
+    for (int i = 0; i < fields; ++i) {
+        if (i > 0) {
+            line += ',';
+        }
+        line += std::to_string(i * 7 + arg_count);
+    }
+    return line;
+}
+
+static int split_join() {
+    std::string line = make_line(2000);
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t comma = line.find(',', start);
+        fields.emplace_back(line, start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    std::string joined;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            joined += ';';
+        }
+        joined += fields[i];
+    }
+    return static_cast<int>(joined.size());
+}
+
+static int tokenize_parse() {
+    std::string line = make_line(2000);
+    std::string_view rest(line);
+    int total = 0;
+    for (;;) {
+        std::size_t comma = rest.find(',');
+        std::string_view field = rest.substr(0, comma);
+        int value = 0;
+        std::from_chars(field.data(), field.data() + field.size(), value);
+        total += value;
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(comma + 1);
+    }
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("split_join", split_join),
+        rl::bench_case("tokenize_parse", tokenize_parse),
+    }, args);
+}
@@ -0,0 +1,45 @@
+// benchmarks/reference/word_count.cpp
+// Hand-written C++ for benchmarks/word_count.rl, timed by the same harness.
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "stdlib/rl_bench.hpp"
+
+static int arg_count = 0;
+
+static std::string make_text(int n) {
+    std::string text;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0) {
+            text += ' ';
+        }
+        text += 'w';
+        text += std::to_string((i * 7919 + arg_count) % 2000);
+    }
+    return text;
+}
+
+static int word_count() {
+    std::string text = make_text(50000);
+    std::unordered_map<std::string, int> counts;
+    std::string_view rest(text);
+    for (;;) {
+        std::size_t space = rest.find(' ');
+        ++counts[std::string(rest.substr(0, space))];
+        if (space == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(space + 1);
+    }
+    return counts["w0"] + counts["w1999"];
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv, argv + argc);
+    arg_count = argc;
+    return rl::run_benchmarks({
+        rl::bench_case("word_count", word_count),
+    }, args);
+}
@@ -0,0 +1,24 @@
+# benchmarks/strings.rl
+# Splitting and joining a CSV-like line. Reference: benchmarks/reference/strings.cpp
+# Run with: python3 redline.py bench-suite strings
+
+# `fields` numbers separated by commas. len(args) keeps the input a run-time value.
+def make_line(fields: int) -> string:
+    var parts: list[string] = list[string](fields)
+    for i in 0..fields:
+        append(parts, to_string(i * 7 + len(args)))
+    return join(parts, ",")
+
+@bench
+def split_join() -> int:
+    val line: string = make_line(2000)
+    val fields: list[string] = split(line, ",")
+    return len(join(fields, ";"))
+
+@bench
+def tokenize_parse() -> int:
+    val line: string = make_line(2000)
+    var total: int = 0
+    for field in tokenize(line, ","):
+        total = total + to_int(field)
+    return total
@@ -0,0 +1,82 @@
+# benchmarks/vector_math.rl
+# Bulk list math builtins against the equivalent scalar REDLINE loops.
+# Run with: python3 redline.py build benchmarks/vector_math.rl --release && ./benchmarks/vector_math
+
+val n: int = 1000000
+val rounds: int = 50
+
+var xs: list[float] = []
+var ys: list[float] = []
+for i in 0..n:
+    append(xs, i * 0.001)
+    append(ys, 1.0 - i * 0.0000005)
+
+def report(name: string, scalar_time: float, bulk_time: float):
+    print(f"{name}: scalar {scalar_time * 1000.0} ms, builtin {bulk_time * 1000.0} ms, speedup {scalar_time / bulk_time}x")
+
+# sum
+var start: float = time()
+var scalar_sum: float = 0.0
+for r in 0..rounds:
+    for i in 0..len(xs):
+        scalar_sum = scalar_sum + xs[i]
+val scalar_sum_time: float = time() - start
+
+start = time()
+var bulk_sum: float = 0.0
+for r in 0..rounds:
+    bulk_sum = bulk_sum + sum(xs)
+report("sum", scalar_sum_time, time() - start)
+
+# dot
+start = time()
+var scalar_dot: float = 0.0
+for r in 0..rounds:
+    for i in 0..len(xs):
+        scalar_dot = scalar_dot + xs[i] * ys[i]
+val scalar_dot_time: float = time() - start
+
+start = time()
+var bulk_dot: float = 0.0
+for r in 0..rounds:
+    bulk_dot = bulk_dot + dot(xs, ys)
+report("dot", scalar_dot_time, time() - start)
+
+# max
+start = time()
+var scalar_max: float = 0.0
+for r in 0..rounds:
+    var best: float = xs[0]
+    for i in 0..len(xs):
+        if xs[i] > best:
+            best = xs[i]
+    scalar_max = scalar_max + best
+val scalar_max_time: float = time() - start
+
+start = time()
+var bulk_max: float = 0.0
+for r in 0..rounds:
+    bulk_max = bulk_max + max(xs)
+report("max", scalar_max_time, time() - start)
+
+# map_sqrt
+var out: list[float] = []
+for i in 0..n:
+    append(out, 0.0)
+
+def sqrt_all(xs: list[float], mut out: list[float]):
+    for i in 0..len(xs):
+        out[i] = sqrt(xs[i])
+
+start = time()
+for r in 0..rounds:
+    sqrt_all(xs, out)
+val scalar_sqrt_time: float = time() - start
+
+start = time()
+for r in 0..rounds:
+    out = map_sqrt(xs)
+report("map_sqrt", scalar_sqrt_time, time() - start)
+
+# Keep the results live so nothing is optimized away.
+print("checksum:", scalar_sum + bulk_sum + scalar_dot + bulk_dot + scalar_max + bulk_max + out[n - 1])
@@ -0,0 +1,22 @@
+# benchmarks/word_count.rl
+# Counting words in a dict. Reference: benchmarks/reference/word_count.cpp
+# Run with: python3 redline.py bench-suite word_count
+
+# `n` words drawn from 2000 distinct ones, separated by spaces.
+def make_text(n: int) -> string:
+    var words: list[string] = list[string](n)
+    for i in 0..n:
+        val k: int = i * 7919 + len(args)
+        append(words, "w" + to_string(k - (k / 2000) * 2000))
+    return join(words, " ")
+
+@bench
+def word_count() -> int:
+    val text: string = make_text(50000)
+    var counts: dict[string, int] = {}
+    for word in split(text, " "):
+        if contains(counts, word):
+            counts[word] = counts[word] + 1
+        else:
+            counts[word] = 1
+    return counts["w0"] + counts["w1999"]
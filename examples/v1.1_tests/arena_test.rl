@@ -0,0 +1,35 @@
+# examples/v1.1_tests/arena_test.rl
+
+print("Testing arena allocation...")
+
+class Request:
+    var id: int = 0
+    var path: string = ""
+
+    def init(i: int, p: string):
+        this.id = i
+        this.path = p
+
+def handle(r: Request) -> int:
+    return r.id * 2
+
+# Every `new` inside the block bump-allocates from one buffer,
+# and the whole lot is released at once when the block ends.
+var total: int = 0
+for round in 0..100:
+    with arena:
+        for i in 0..1000:
+            val r: Request = new Request(i, "/index")
+            total = total + handle(r)
+print("Total:", total)
+
+# The initial buffer size can be given up front.
+var kept: int = 0
+with arena(1024 * 1024):
+    var batch: list[Request] = []
+    for i in 0..500:
+        append(batch, new Request(i, "/batch"))
+    kept = len(batch)
+print("Batch size:", kept)
+
+print("Arena test finished.")
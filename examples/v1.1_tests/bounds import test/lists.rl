@@ -0,0 +1,6 @@
+# examples/v1.1_tests/bounds import test/lists.rl
+
+# Reuses a builtin's name, and unlike the builtin it changes the list's length.
+pub def sum(mut values: list[int]) -> int:
+    clear(values)
+    return 0
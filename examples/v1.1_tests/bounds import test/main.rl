@@ -0,0 +1,18 @@
+# examples/v1.1_tests/bounds import test/main.rl
+
+import "lists.rl"
+
+print("Testing bounds checks around an imported function...")
+
+# `sum` here is the one from lists.rl, which clears the list, so the loop
+# can't be proven in range and counts[i] stays checked in release builds.
+var counts: list[int] = [1, 2, 3]
+try:
+    var counted: int = 0
+    for i in 0..len(counts):
+        counted = counted + sum(counts) + counts[i]
+    print(counted)
+catch e:
+    print("Caught access after an imported sum() cleared the list.")
+
+print("Bounds import test finished.")
@@ -0,0 +1,104 @@
+# examples/v1.1_tests/bounds_test.rl
+
+print("Testing bounds-check elimination...")
+
+var xs: list[int] = []
+for i in 0..1000:
+    append(xs, i)
+
+# `i` runs over 0..len(xs) and xs is never resized in the body, so xs[i]
+# is always in bounds. Release builds drop the check here.
+var total: int = 0
+for i in 0..len(xs):
+    total = total + xs[i]
+print("Sum:", total)
+
+# Writing elements doesn't change the length, so this loop qualifies too.
+for i in 0..len(xs):
+    xs[i] = xs[i] * 2
+print("Doubled last:", xs[999])
+
+# Appending inside the loop does: these accesses stay checked.
+var grown: list[int] = [1, 2, 3]
+for i in 0..len(grown):
+    if grown[i] == 2:
+        append(grown, 4)
+print("Grown length:", len(grown))
+
+# unsafe_get skips the check in release builds when the compiler can't prove it.
+var stride_total: int = 0
+var j: int = 0
+while j < len(xs):
+    stride_total = stride_total + unsafe_get(xs, j)
+    j = j + 10
+print("Every tenth:", stride_total)
+
+# Out-of-range accesses the compiler can't prove are still caught.
+try:
+    print(xs[5000])
+catch e:
+    print("Caught out of range access.")
+
+# A bare name in a method can be a field, which another method can resize
+# without the list ever being passed to it: these accesses stay checked.
+class Queue:
+    var items: list[int] = []
+
+    def init():
+        this.items = [1, 2, 3]
+
+    def drop():
+        clear(this.items)
+
+    def drain() -> int:
+        var taken: int = 0
+        for i in 0..len(items):
+            this.drop()
+            taken = taken + items[i]
+        return taken
+
+try:
+    val q: Queue = new Queue()
+    print(q.drain())
+catch e:
+    print("Caught access after a method cleared the field.")
+
+# A function reusing a builtin's name gets no builtin's trust.
+def sum(mut values: list[int]) -> int:
+    clear(values)
+    return 0
+
+var counts: list[int] = [1, 2, 3]
+try:
+    var counted: int = 0
+    for i in 0..len(counts):
+        counted = counted + sum(counts) + counts[i]
+    print(counted)
+catch e:
+    print("Caught access after a user sum() cleared the list.")
+
+# The caller can pass one list as two parameters, so clearing `b` may clear
+# `a` too: a loop over a parameter stays checked if the body resizes another one.
+def drain_into(mut a: list[int], mut b: list[int]) -> int:
+    var seen: int = 0
+    for i in 0..len(a):
+        clear(b)
+        seen = seen + a[i]
+    return seen
+
+var shared: list[int] = [1, 2, 3]
+try:
+    print(drain_into(shared, shared))
+catch e:
+    print("Caught access after clearing an aliased parameter.")
+
+# Writing elements of another parameter can't resize anything, so this stays unchecked.
+def doubled_into(mut out: list[int], values: list[int]) -> int:
+    for i in 0..len(values):
+        out[i] = values[i] * 2
+    return out[0]
+
+var doubled: list[int] = [0, 0, 0]
+print("Doubled into:", doubled_into(doubled, [4, 5, 6]))
+
+print("Bounds test finished.")
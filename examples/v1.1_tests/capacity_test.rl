@@ -0,0 +1,45 @@
+# examples/v1.1_tests/capacity_test.rl
+
+print("Testing list capacity control...")
+
+# list[T](n) starts empty, with room for n elements.
+var squares: list[int] = list[int](1000)
+val room: int = capacity(squares)
+print("Preallocated:", len(squares), room >= 1000)
+for i in 0..1000:
+    append(squares, i * i)
+print("Filled without growing:", len(squares), capacity(squares) == room)
+
+# reserve() on an existing list.
+var words: list[string] = []
+reserve(words, 64)
+val reserved: int = capacity(words)
+for i in 0..64:
+    append(words, "w" + to_string(i))
+print("Reserved 64:", reserved >= 64, "kept:", capacity(words) == reserved, "last:", words[63])
+
+# resize() grows with default values and shrinks from the end.
+var slots: list[float] = [1.5, 2.5]
+resize(slots, 5)
+print("Grown:", len(slots), slots[1], slots[4])
+resize(slots, 1)
+print("Shrunk:", len(slots), slots[0])
+
+# clear() keeps the memory; shrink_to_fit() hands it back.
+clear(squares)
+print("Cleared:", len(squares), "capacity kept:", capacity(squares) >= 1000)
+shrink_to_fit(squares)
+print("After shrink_to_fit:", capacity(squares))
+
+# Literals of strings and nested lists are built in place.
+val names: list[string] = ["ada", "grace", "edsger"]
+val grid: list[list[string]] = [["a", "b"], [], ["c"]]
+val counts: list[list[int]] = [[1, 2, 3], [4]]
+print("Literals:", join(names, " "), len(grid), join(grid[0], ""), len(grid[1]), counts[0][2], counts[1][0])
+
+try:
+    reserve(words, 0 - 1)
+catch e:
+    print("Caught negative capacity.")
+
+print("Capacity test finished.")
@@ -0,0 +1,58 @@
+# examples/v1.1_tests/constant_fold_test.rl
+
+print("Testing constant folding...")
+
+# Literal arithmetic is evaluated by the compiler, with C++'s int and float rules.
+print("Arithmetic:", 2 + 3 * 4, 7 / 2, 0 - 7 / 2, 7.0 / 2, 1 + 0.5, 10 - 2 - 3)
+print("Comparisons:", 3 < 4, 2.5 >= 3, 1 == 1.0, true != false, "a" == "a")
+print("Strings:", "con" + "cat" + "enated", len("folded"))
+print("Builtins:", sqrt(16.0), floor(2.75), max(1.5, 2.5), PI * 2.0)
+
+# Scalar vals with constant initializers are constants; so is anything built from them.
+val WIDTH: int = 40
+val HEIGHT: int = WIDTH / 2
+val AREA: int = WIDTH * HEIGHT
+val SCALE: float = 3
+print("Derived constants:", HEIGHT, AREA, SCALE / 2)
+
+# A configuration flag: the branch that can't run is dropped before codegen.
+val VERBOSE: bool = false
+val USE_FAST_PATH: bool = WIDTH > 10
+
+def checksum(n: int) -> int:
+    val STEP: int = 3
+    val FAST: bool = STEP > 1
+    var total: int = 0
+    for i in 0..n:
+        if FAST:
+            total = total + i * STEP
+        else:
+            total = total + i
+    return total
+
+var total: int = 0
+for i in 0..100:
+    if USE_FAST_PATH:
+        total = total + i * 2
+    else:
+        total = total + i
+    if VERBOSE:
+        print("step", i)
+print("Flag-driven loop:", total)
+print("Function-local constant:", checksum(10))
+
+# Division by zero (and int overflow) is never folded; it is left to run time.
+print("Division by zero at run time:", 1.0 / 0.0)
+
+# A val that is written to anyway stays a plain variable.
+val counter: int = 1
+counter = counter + 1
+print("Written val:", counter)
+
+if not_a_constant():
+    print("Runtime condition kept.")
+
+print("Constant fold test finished.")
+
+def not_a_constant() -> bool:
+    return len(args) > 0
@@ -0,0 +1,38 @@
+# examples/v1.1_tests/contextual_keywords_test.rl
+
+print("Testing contextual keywords as names...")
+
+# mut, move, with, spawn, lock and unique are only keywords where
+# they introduce something, so older programs using them as names still work.
+def move(from: int, to: int) -> int:
+    return to - from
+
+def lock(mut items: list[int]) -> int:
+    append(items, 4)
+    return len(items)
+
+var mut: int = 1
+val with: string = "with"
+var unique: list[int] = [1, 2, 3]
+val spawn: int = move(mut, 10)
+val locked: int = lock(unique)
+print("Names:", mut, with, spawn, locked, len(unique))
+
+# The keywords themselves still work next to those names.
+def grow(mut xs: list[int], move extra: list[int]) -> int:
+    for x in extra:
+        append(xs, x)
+    return len(xs)
+
+struct Point:
+    var x: int = 0
+
+unique class Counter:
+    var n: int = 0
+
+val m: mutex = mutex()
+lock m:
+    mut = mut + 1
+print("Keywords:", grow(unique, [5, 6]), mut)
+
+print("Contextual keywords test finished.")
@@ -0,0 +1,34 @@
+# examples/v1.1_tests/conversion_test.rl
+
+print("Testing number conversions...")
+
+# Floats print and convert as the shortest text that reads back as the same value.
+print("Floats:", 0.1, 2.5, 1.0 / 3.0, 100.0, 1000000.0 * 1000000.0 * 1000000000.0)
+print("to_string:", to_string(0.1) + "|" + to_string(0 - 42) + "|" + to_string(0.15 / 1000000.0))
+val third: float = 1.0 / 3.0
+print("Round trip:", to_float(to_string(third)) == third)
+
+# Parsing allows surrounding spaces and a leading '+', like a CSV cell.
+print("to_int:", to_int("42"), to_int(" -17 "), to_int("+8"))
+print("to_float:", to_float("3.25"), to_float("1e-3"), to_float(" 6 "))
+
+# Parsing a column of a line works straight from the tokens, with no copies.
+var sum: int = 0
+for field in tokenize("10,20,30,40", ","):
+    sum = sum + to_int(field)
+print("Column sum:", sum)
+
+# try_to_int / try_to_float give back a fallback instead of throwing.
+print("Fallbacks:", try_to_int("12", 0 - 1), try_to_int("12abc", 0 - 1), try_to_int("", 0), try_to_float("x", 0.5))
+
+try:
+    to_int("12abc")
+catch e:
+    print("Caught trailing garbage.")
+
+try:
+    to_int("99999999999")
+catch e:
+    print("Caught an int that doesn't fit.")
+
+print("Conversion test finished.")
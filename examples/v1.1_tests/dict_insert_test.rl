@@ -0,0 +1,40 @@
+# examples/v1.1_tests/dict_insert_test.rl
+
+print("Testing dict inserts and contains...")
+
+var ages: dict[string, int] = {
+    "Alice": 30,
+    "Bob": 41
+}
+var ranks: ordered_dict[int, string] = {
+    1: "gold",
+    2: "silver"
+}
+
+# Assigning to a missing key adds it; assigning to an existing one overwrites it.
+ages["Carol"] = 27
+ages["Bob"] = 42
+ranks[4] = "honourable mention"
+print("Added:", ages["Carol"], ages["Bob"], ranks[4])
+
+# contains() checks for a key without the error a missing read raises.
+print("Contains:", contains(ages, "Carol"), contains(ages, "Dave"), contains(ranks, 4), contains(ranks, 9))
+
+var counts: dict[string, int] = {}
+for word in split("a b a c b a", " "):
+    if contains(counts, word):
+        counts[word] = counts[word] + 1
+    else:
+        counts[word] = 1
+print("Counts:", counts["a"], counts["b"], counts["c"])
+
+# Copying one key of a dict to a new key: the insert may grow the dict, and
+# the copied value must survive it.
+var names: dict[string, string] = {"k0": "zero"}
+names["k1"] = names["k0"]
+names["k2"] = names["k1"]
+var sorted_names: ordered_dict[string, string] = {"k0": "zero"}
+sorted_names["k1"] = sorted_names["k0"]
+print("Copied:", names["k1"], names["k2"], sorted_names["k1"])
+
+print("Dict insert test finished.")
@@ -0,0 +1,26 @@
+# examples/v1.1_tests/file_stream_test.rl
+
+print("Testing memory-mapped and streaming file I/O...")
+
+val path: string = "file_stream_test.txt"
+write_file(path, "alpha,1\nbeta,2\r\ngamma,3")
+
+# read_file sizes its buffer once and reads the whole file in one go.
+val text: string = read_file(path)
+print("read_file length:", len(text))
+
+# map_file doesn't read anything up front; pages are loaded as they're touched.
+val mapped: mapped_file = map_file(path)
+print("mapped length:", len(mapped))
+print("mapped contains beta:", contains(mapped, "beta"))
+print("mapped equals read_file:", to_string(mapped) == text)
+
+# lines() streams the file through a small buffer, one line at a time.
+var count: int = 0
+for line in lines(path):
+    count = count + 1
+    print(count, line, len(line))
+print("Line count:", count)
+
+remove(path)
+print("File stream test finished.")
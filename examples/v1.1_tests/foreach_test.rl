@@ -0,0 +1,49 @@
+# examples/v1.1_tests/foreach_test.rl
+
+print("Testing for-each loops...")
+
+# Elements are bound by const reference: no copy per iteration, no index checks.
+val words: list[string] = ["alpha", "beta", "gamma"]
+var total: int = 0
+for w in words:
+    total = total + len(w)
+print("Total length:", total)
+
+# 'mut' binds by reference, so writes go to the list itself.
+var prices: list[float] = [1.0, 2.5, 4.0]
+for mut p in prices:
+    p = p * 2.0
+print("Doubled:", prices[0], prices[1], prices[2])
+
+var rows: list[list[int]] = [[1, 2], [3]]
+for mut row in rows:
+    append(row, 0)
+print("Rows grown:", len(rows[0]), len(rows[1]))
+
+# Dicts yield key-value pairs; an ordered_dict yields them sorted by key.
+var stock: ordered_dict[string, int] = {"pears": 3, "apples": 5, "figs": 1}
+for name, count in stock:
+    print(name, count)
+
+# With 'mut' the values can be updated in place; keys stay read-only.
+for mut name, count in stock:
+    count = count * 2
+print("Restocked:", stock["apples"], stock["figs"], stock["pears"])
+
+var counts: dict[string, int] = {"a": 1, "b": 2}
+var sum_of_counts: int = 0
+for key, n in counts:
+    sum_of_counts = sum_of_counts + n
+print("Dict sum:", sum_of_counts)
+
+# A mutating loop over a parameter gives the function its own copy.
+def zeroed(xs: list[int]) -> list[int]:
+    for mut x in xs:
+        x = 0
+    return xs
+
+val original: list[int] = [7, 8, 9]
+val cleared: list[int] = zeroed(original)
+print("Original kept:", original[0], "copy zeroed:", cleared[0])
+
+print("For-each test finished.")
@@ -0,0 +1,25 @@
+# examples/v1.1_tests/format_test.rl
+
+print("Testing f-string formatting...")
+
+val user: string = "Ada"
+val visits: int = 42
+val ratio: float = 0.75
+val admin: bool = false
+
+# Each f-string compiles to a single rl::format call that sizes the result once.
+val line: string = f"user={user} visits={visits} ratio={ratio} admin={admin}"
+print(line)
+
+# Expressions, escapes and non-ASCII text all work inside f-strings.
+print(f"next visit: {visits + 1}\t(tab)")
+print(f"quote: \"{user}\" — ünïcödé")
+
+# Building keys in a loop is the hot path this is meant for.
+var keys: list[string] = []
+for i in 0..3:
+    val key: string = f"{user}:{i}"
+    append(keys, key)
+print(join(keys, ", "))
+
+print("Format test finished.")
@@ -0,0 +1,67 @@
+# examples/v1.1_tests/move_locals_test.rl
+
+print("Testing moves at a local's last use...")
+
+# Each row is built up locally and then appended: the row is moved into the
+# table instead of being copied.
+def build_table(rows: int, cols: int) -> list[list[string]]:
+    var table: list[list[string]] = []
+    for r in 0..rows:
+        var row: list[string] = []
+        for c in 0..cols:
+            append(row, to_string(r * cols + c))
+        append(table, row)
+    return table
+
+# 'words' is written to, so it's taken by value and a caller's last use moves into it.
+def tagged(words: list[string], tag: string) -> list[string]:
+    append(words, tag)
+    return words
+
+val table: list[list[string]] = build_table(3, 4)
+print("Rows:", len(table), "last row:", join(table[2], " "))
+
+var draft: list[string] = ["a", "b"]
+append(draft, "c")
+val final: list[string] = tagged(draft, "done")
+print("Tagged:", join(final, ","))
+
+# A local that is still read afterwards is copied, not moved.
+var kept: list[string] = ["x", "y"]
+var copy: list[string] = kept
+append(copy, "z")
+print("Kept:", join(kept, ","), "copy:", join(copy, ","))
+
+# Only the branch that ends with the value's last use moves it.
+var name: string = "redline"
+var names: list[string] = []
+if len(name) > 3:
+    append(names, name)
+else:
+    print("short:", name)
+print("Names:", join(names, ","))
+
+# Inside a loop the same value is used by every iteration, so it isn't moved.
+val line: string = "repeat"
+var repeated: list[string] = []
+for i in 0..3:
+    append(repeated, line)
+print("Repeated:", join(repeated, " "))
+
+# A view into a string keeps it in use: the string is only moved after the view's last use.
+var greeting: string = "hello"
+val first_view: str_view = greeting
+var greetings: list[string] = []
+append(greetings, greeting)
+print("View after append:", first_view, "stored:", greetings[0])
+
+# The same goes for views split out of it and kept in a list.
+var csv_line: string = "ab,cd,ef"
+var fields: list[str_view] = []
+for field in split_view(csv_line, ","):
+    append(fields, field)
+var csv_lines: list[string] = []
+append(csv_lines, csv_line)
+print("Fields after append:", fields[0], fields[2], "stored:", csv_lines[0])
+
+print("Move locals test finished.")
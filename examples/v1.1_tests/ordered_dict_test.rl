@@ -0,0 +1,31 @@
+# examples/v1.1_tests/ordered_dict_test.rl
+
+print("Testing dict and ordered_dict...")
+
+# dict is a hash map: fast lookups, no ordering guarantees.
+var ages: dict[string, int] = {
+    "Alice": 30,
+    "Bob": 41
+}
+ages["Bob"] = 42
+print("Bob is " + to_string(ages["Bob"]))
+
+# ordered_dict keeps its keys sorted.
+var ranks: ordered_dict[int, string] = {
+    3: "bronze",
+    1: "gold",
+    2: "silver"
+}
+print("Rank 1 is " + ranks[1])
+
+def lookup(table: dict[string, int], key: string) -> int:
+    return table[key]
+
+print("Alice via lookup: " + to_string(lookup(ages, "Alice")))
+
+try:
+    print(ages["Nobody"])
+catch e:
+    print("Missing key raised an error. Safe.")
+
+print("Dict test finished.")
@@ -0,0 +1,74 @@
+# examples/v1.1_tests/parallel_test.rl
+
+print("Testing parallel for loops and reductions...")
+
+val n: int = 30000
+
+# Every iteration writes its own element, so no locking is needed.
+var doubled: list[int] = []
+for i in 0..n:
+    append(doubled, 0)
+parallel for i in 0..len(doubled):
+    doubled[i] = i * 2
+print("doubled[999]:", doubled[999])
+
+# reduce gives each thread a private total and combines them at the end.
+var total: int = 0
+parallel for i in 0..len(doubled) reduce sum into total:
+    total = total + doubled[i]
+print("Sum:", total)
+
+# The reduction starts from the variable's current value.
+var count: int = 1000
+parallel for i in 0..n reduce sum into count:
+    if i / 3 * 3 == i:
+        count = count + 1
+print("Count:", count)
+
+var smallest: int = 1000000
+parallel for i in 0..n reduce min into smallest:
+    val v: int = (i - 12345) * (i - 12345) + 5
+    if v < smallest:
+        smallest = v
+print("Smallest:", smallest)
+
+var largest: float = 0.0
+parallel for i in 1..n reduce max into largest:
+    val v: float = 1.0 / i
+    if v > largest:
+        largest = v
+print("Largest:", largest)
+
+var factorial: int = 1
+parallel for i in 1..11 reduce product into factorial:
+    factorial = factorial * i
+print("10!:", factorial)
+
+# Loops with nothing to do are fine.
+var none: int = 0
+parallel for i in 5..5 reduce sum into none:
+    none = none + 1
+print("Empty range:", none)
+
+# An error raised in any chunk reaches the caller.
+try:
+    parallel for i in 0..n:
+        if i == 777:
+            print(doubled[n + i])
+catch e:
+    print("Caught error from a parallel chunk.")
+
+# A parallel loop inside another runs inline on whichever thread reaches it,
+# including the one that started the outer loop.
+var grid: list[int] = []
+for i in 0..1000000:
+    append(grid, 0)
+parallel for i in 0..1000:
+    parallel for j in 0..1000:
+        grid[i * 1000 + j] = (i + j) / 100
+var grid_total: int = 0
+for i in 0..len(grid):
+    grid_total = grid_total + grid[i]
+print("Nested grid total:", grid_total, "corner:", grid[999999])
+
+print("Parallel test finished.")
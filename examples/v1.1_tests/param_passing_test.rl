@@ -0,0 +1,51 @@
+# examples/v1.1_tests/param_passing_test.rl
+
+print("Testing parameter passing...")
+
+# Read-only parameters are passed by const reference: no copy of the list.
+def count_matches(words: list[string], needle: string) -> int:
+    var total: int = 0
+    for i in 0..len(words):
+        if contains(words[i], needle):
+            total = total + 1
+    return total
+
+# Writing to a parameter keeps it a private copy; the caller's list is untouched.
+def with_extra(words: list[string]) -> int:
+    val extra: string = "extra"
+    append(words, extra)
+    return len(words)
+
+# 'mut' parameters are passed by reference, so changes are visible to the caller.
+def add_word(mut words: list[string], word: string):
+    append(words, word)
+
+# 'move' parameters take ownership; the list is moved into the return value.
+def consume(move words: list[string]) -> list[string]:
+    val marker: string = "consumed"
+    append(words, marker)
+    return words
+
+# The last use of a 'move' parameter is moved only into something that takes it
+# by value: a mutating builtin or a 'mut' parameter gets the parameter itself.
+def append_last(move words: list[string]) -> int:
+    append(words, "last")
+    return 1
+
+def grow_last(move words: list[string]) -> int:
+    add_word(words, "grown")
+    return 1
+
+var words: list[string] = ["alpha", "beta"]
+print("Words containing 'a': " + to_string(count_matches(words, "a")))
+print("Copy has " + to_string(with_extra(words)) + " words, original has " + to_string(len(words)))
+
+add_word(words, "gamma")
+print("After add_word: " + join(words, ", "))
+
+print("Consumed last uses:", append_last(["x"]), grow_last(["y"]))
+
+val result: list[string] = consume(move words)
+print("After consume: " + join(result, ", "))
+
+print("Parameter passing test finished.")
@@ -0,0 +1,20 @@
+# examples/v1.1_tests/print_test.rl
+
+print("Testing buffered print...")
+
+# Several values in one print are separated by spaces, without building a string.
+val name: string = "Redline"
+val version: float = 1.1
+print("Language:", name, "version", version, "stable:", true)
+print()
+
+# Bulk output is buffered and written in large chunks.
+for i in 0..5:
+    print("line", i)
+
+# Flush explicitly before doing something slow, so the user sees progress.
+print_unbuffered("Flushed right away.")
+print("Buffered again.")
+flush()
+
+print("Print test finished.")
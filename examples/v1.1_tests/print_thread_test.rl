@@ -0,0 +1,18 @@
+# examples/v1.1_tests/print_thread_test.rl
+
+print("Testing print from several threads...")
+
+# Every thread prints the same line, so the output doesn't depend on how the
+# threads interleave. A lost line changes the count; a line printed in pieces
+# shows up as a different line. `sort | uniq -c` shows a single line, 15000 times.
+def shout(times: int):
+    for i in 0..times:
+        print("worker", "line", 42, true)
+
+var workers: list[task[void]] = []
+for t in 0..3:
+    append(workers, spawn shout(5000))
+for t in 0..len(workers):
+    join(workers[t])
+
+print("Print thread test finished.")
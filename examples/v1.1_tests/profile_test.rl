@@ -0,0 +1,36 @@
+# examples/v1.1_tests/profile_test.rl
+
+print("Testing a program built for profiling...")
+
+# Build with `redline build --profile=timers` to get a per-function table on
+# stderr at exit, or with `--profile` to run it under perf or gdb with .rl lines.
+
+def fib(n: int) -> int:
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+def row_sums(rows: int, cols: int) -> list[int]:
+    var sums: list[int] = []
+    for r in 0..rows:
+        var total: int = 0
+        for c in 0..cols:
+            total = total + r * c
+        append(sums, total)
+    return sums
+
+class Counter:
+    var count: int = 0
+
+    def bump(times: int):
+        for i in 0..times:
+            this.count = this.count + 1
+
+print("fib(20):", fib(20))
+val sums: list[int] = row_sums(100, 100)
+print("Row sums:", len(sums), sums[99])
+val counter: Counter = new Counter()
+counter.bump(1000)
+print("Counter:", counter.count)
+
+print("Profile test finished.")
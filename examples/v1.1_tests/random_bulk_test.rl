@@ -0,0 +1,62 @@
+# examples/v1.1_tests/random_bulk_test.rl
+
+print("Testing seeded and bulk random numbers...")
+
+def within(x: float, limit: float) -> bool:
+    return abs(x) < limit
+
+# The same seed gives the same numbers on every run.
+seed(2024)
+val first: int = random_int(1, 1000000)
+val first_float: float = random_float()
+seed(2024)
+val again: int = random_int(1, 1000000)
+val again_float: float = random_float()
+print("Reproducible:", first == again, first_float == again_float)
+
+val dice: list[int] = random_ints(60000, 1, 6)
+var counts: list[int] = [0, 0, 0, 0, 0, 0, 0]
+var out_of_range: int = 0
+for i in 0..len(dice):
+    if dice[i] < 1:
+        out_of_range = out_of_range + 1
+    else:
+        if dice[i] > 6:
+            out_of_range = out_of_range + 1
+        else:
+            counts[dice[i]] = counts[dice[i]] + 1
+print("Dice out of range:", out_of_range)
+var fair: bool = true
+for face in 1..7:
+    if counts[face] < 9500:
+        fair = false
+    if counts[face] > 10500:
+        fair = false
+print("Every face close to 10000:", fair)
+
+val xs: list[float] = random_floats(100000)
+var in_unit: bool = true
+for i in 0..len(xs):
+    if xs[i] < 0.0:
+        in_unit = false
+    if xs[i] >= 1.0:
+        in_unit = false
+val mean: float = sum(xs) / len(xs)
+print("Floats in [0, 1):", in_unit)
+print("Mean is about 0.5:", within(mean - 0.5, 0.01))
+
+# Each thread draws from its own stream.
+def draw(count: int) -> float:
+    return sum(random_floats(count))
+
+val a: task[float] = spawn draw(1000)
+val b: task[float] = spawn draw(1000)
+print("Threads get different streams:", join(a) != join(b))
+
+print("Empty bulk request:", len(random_floats(0)))
+try:
+    print(random_int(10, 1))
+catch e:
+    print("Caught empty range.")
+
+print("Random bulk test finished.")
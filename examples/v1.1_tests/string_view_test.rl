@@ -0,0 +1,41 @@
+# examples/v1.1_tests/string_view_test.rl
+
+print("Testing string views...")
+
+val line: string = "id,name,score,team"
+
+# split_view hands back views into `line` instead of copying each field.
+val fields: list[str_view] = split_view(line, ",")
+print("Field count:", len(fields))
+print("Second field:", fields[1], "length", len(fields[1]))
+
+# A view converts back to a string when you need to keep it.
+val name: string = to_string(fields[1])
+print("Copied name:", name)
+
+# tokenize walks the fields lazily, without building a list at all.
+var count: int = 0
+for field in tokenize(line, ","):
+    count = count + 1
+    print(count, field)
+
+# The range keeps its own copy of the delimiter, so a temporary one is fine.
+def separator() -> string:
+    return " <field separator> "
+
+val spaced: string = "alpha <field separator> beta <field separator> gamma"
+for word in tokenize(spaced, separator()):
+    val padding: string = "overwrites the freed delimiter, if it was freed"
+    print("Spaced word:", word, len(padding))
+
+# contains and friends take views, so literals don't become temporary strings.
+print("Has score:", contains(line, "score"))
+print("View has am:", contains(fields[3], "am"))
+
+# join sizes its output once before copying the pieces in.
+val parts: list[string] = split(line, ",")
+print("Joined:", join(parts, " | "))
+print("Joined views:", join(fields, "-"))
+print(f"f-string with a view: {fields[0]}!")
+
+print("String view test finished.")
@@ -0,0 +1,79 @@
+# examples/v1.1_tests/struct_test.rl
+
+print("Testing structs and unique classes...")
+
+# A struct is a plain value: no heap allocation, stored inline in lists.
+struct Point:
+    var x: int = 0
+    var y: int = 0
+
+    def init(px: int, py: int):
+        this.x = px
+        this.y = py
+
+    def length_squared() -> int:
+        return this.x * this.x + this.y * this.y
+
+# Structs are copied when passed, so the callee changes its own copy.
+def shifted(p: Point, dx: int) -> Point:
+    p.x = p.x + dx
+    return p
+
+def describe(p: Point) -> string:
+    return f"({p.x}, {p.y})"
+
+var points: list[Point] = []
+for i in 0..4:
+    append(points, new Point(i, i * 2))
+
+var total: int = 0
+for i in 0..len(points):
+    total = total + points[i].length_squared()
+print("Sum of squared lengths:", total)
+
+val origin: Point = new Point(1, 1)
+val moved: Point = shifted(origin, 10)
+print("Original:", describe(origin), "shifted:", describe(moved))
+
+# Assigning a struct copies it.
+var copy: Point = origin
+copy.y = 99
+print("Copy:", describe(copy), "original:", describe(origin))
+
+# Writing a field of a struct in a list writes the list, so the parameter is
+# a private copy and the caller's points are untouched.
+def first_moved_to(ps: list[Point], x: int) -> int:
+    ps[0].x = x
+    return ps[0].x
+
+print("Moved first:", first_moved_to(points, 5), "caller's first:", points[0].x)
+
+# Structs work as dict values too.
+var named: dict[string, Point] = {"home": new Point(3, 4)}
+print("Home:", describe(named["home"]))
+
+# A unique class has exactly one owner and no reference count.
+unique class Buffer:
+    var size: int = 0
+
+    def init(n: int):
+        this.size = n
+
+    def grow(n: int):
+        this.size = this.size + n
+
+def grow_twice(b: Buffer):
+    b.grow(1)
+    b.grow(1)
+
+var buffer: Buffer = new Buffer(8)
+grow_twice(buffer)
+print("Buffer size:", buffer.size)
+
+# Ownership moves explicitly; lists of unique objects work too.
+var buffers: list[Buffer] = []
+append(buffers, move buffer)
+append(buffers, new Buffer(16))
+print("Buffers:", len(buffers), "first size:", buffers[0].size)
+
+print("Struct test finished.")
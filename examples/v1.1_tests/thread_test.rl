@@ -0,0 +1,71 @@
+# examples/v1.1_tests/thread_test.rl
+
+print("Testing threads, locks, atomics and channels...")
+
+def square_sum(from: int, to: int) -> int:
+    var total: int = 0
+    for i in from..to:
+        total = total + i * i
+    return total
+
+# spawn runs a call on its own thread; join waits for the result.
+var tasks: list[task[int]] = []
+for t in 0..4:
+    append(tasks, spawn square_sum(t * 250, (t + 1) * 250))
+var total: int = 0
+for t in 0..len(tasks):
+    total = total + join(tasks[t])
+print("Sum of squares:", total)
+
+# An atomic counter needs no lock.
+def count_up(counter: atomic[int], times: int):
+    for i in 0..times:
+        counter.fetch_add(1)
+
+val counter: atomic[int] = atomic(0)
+var workers: list[task[void]] = []
+for t in 0..4:
+    append(workers, spawn count_up(counter, 10000))
+for t in 0..len(workers):
+    join(workers[t])
+print("Counter:", counter.load())
+
+# A lock block holds the mutex until the block ends.
+class Ledger:
+    var balance: int = 0
+    var guard: mutex = mutex()
+
+    def deposit(amount: int):
+        lock this.guard:
+            this.balance = this.balance + amount
+
+def deposit_many(ledger: Ledger, times: int):
+    for i in 0..times:
+        ledger.deposit(1)
+
+val ledger: Ledger = new Ledger()
+val a: task[void] = spawn deposit_many(ledger, 5000)
+val b: task[void] = spawn deposit_many(ledger, 5000)
+join(a)
+join(b)
+print("Balance:", ledger.balance)
+
+# Channels connect producers and consumers; `for x in ch` runs until it's closed.
+def produce(ch: channel[int], count: int):
+    for i in 0..count:
+        ch.send(i)
+    ch.close()
+
+def consume(ch: channel[int]) -> int:
+    var sum: int = 0
+    for value in ch:
+        sum = sum + value
+    return sum
+
+val ch: channel[int] = channel(64)
+val consumer: task[int] = spawn consume(ch)
+produce(ch, 1000)
+print("Received sum:", join(consumer))
+print("CPU count is positive:", cpu_count() > 0)
+
+print("Thread test finished.")
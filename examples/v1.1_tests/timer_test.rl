@@ -0,0 +1,34 @@
+# examples/v1.1_tests/timer_test.rl
+
+print("Testing monotonic timers and @bench functions...")
+
+val start: float = now_ns()
+val sw: stopwatch = stopwatch()
+sleep(0.02)
+val waited: float = now_ns() - start
+print("now_ns advanced at least 20 ms:", waited >= 20000000.0)
+print("stopwatch saw it too:", sw.elapsed_ms() >= 20.0, sw.elapsed() >= 0.02)
+
+var later: stopwatch = stopwatch()
+later.reset()
+print("Just reset:", later.elapsed_ns() < 20000000.0)
+
+# In a normal build, @bench functions are ordinary functions;
+# `redline bench timer_test.rl` runs them under the benchmark harness instead.
+@bench
+def sum_squares() -> int:
+    var total: int = 0
+    for i in 0..1000:
+        total = total + i * i
+    return total
+
+@bench
+def build_list():
+    var xs: list[int] = []
+    for i in 0..100:
+        append(xs, i)
+
+print("sum_squares():", sum_squares())
+build_list()
+
+print("Timer test finished.")
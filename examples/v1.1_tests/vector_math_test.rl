@@ -0,0 +1,57 @@
+# examples/v1.1_tests/vector_math_test.rl
+
+print("Testing bulk list math...")
+
+var xs: list[float] = []
+var ys: list[float] = []
+var ns: list[int] = []
+for i in 0..21:
+    append(xs, i * 0.5)
+    append(ys, 2.0)
+    append(ns, i - 10)
+
+print("sum:", sum(xs), sum(ns))
+print("dot:", dot(xs, ys), dot(ns, ns))
+print("min/max:", min(xs), max(xs), min(ns), max(ns))
+
+val scaled: list[float] = scale(xs, 4.0)
+val total: list[float] = add(xs, ys)
+val diff: list[int] = sub(ns, ns)
+val squares: list[int] = mul(ns, ns)
+val roots: list[float] = map_sqrt(scale(xs, 2.0))
+print("scale:", scaled[20], "add:", total[3], "sub:", diff[7], "mul:", squares[0])
+print("map_sqrt:", roots[8], roots[18])
+
+# The scalar min/max still work alongside the list versions.
+print("min(3.0, 1.5):", min(3.0, 1.5))
+
+# A NaN is skipped wherever it lands relative to the SIMD blocks; only a NaN
+# first element is kept, as with the scalar loop.
+val nan: float = to_float("nan")
+var nan_mismatches: int = 0
+for p in 1..21:
+    var holed: list[float] = []
+    for i in 0..21:
+        append(holed, i * 0.5 + 1.0)
+    holed[p] = nan
+    var expected_max: float = 11.0
+    if p == 20:
+        expected_max = 10.5
+    if min(holed) != 1.0:
+        nan_mismatches = nan_mismatches + 1
+    if max(holed) != expected_max:
+        nan_mismatches = nan_mismatches + 1
+print("NaN mismatches:", nan_mismatches)
+
+val empty: list[float] = []
+print("sum of empty:", sum(empty))
+try:
+    print(max(empty))
+catch e:
+    print("Caught max of an empty list.")
+try:
+    print(dot(xs, empty))
+catch e:
+    print("Caught mismatched lengths.")
+
+print("Vector math test finished.")
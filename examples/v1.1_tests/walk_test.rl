@@ -0,0 +1,47 @@
+# examples/v1.1_tests/walk_test.rl
+
+print("Testing directory walking...")
+
+val root: string = "walk_test_tree"
+mkdir(root)
+mkdir(root + "/src")
+mkdir(root + "/src/deep")
+write_file(root + "/README", "hello")
+write_file(root + "/src/main.rl", "print(1)\n")
+write_file(root + "/src/deep/data.csv", "a,b,c\n1,2,3\n")
+
+# walk() visits the whole tree lazily; each entry carries its type, size and mtime.
+var files: int = 0
+var dirs: int = 0
+# Sizes are floats, so files past the int range still add up exactly.
+var bytes: float = 0.0
+var newest: float = 0.0
+for e in walk(root):
+    if e.is_dir:
+        dirs = dirs + 1
+    if e.is_file:
+        files = files + 1
+        bytes = bytes + e.size
+    if e.mtime > newest:
+        newest = e.mtime
+print("Files:", files, "dirs:", dirs, "bytes:", bytes, "recent:", newest > time() - 3600.0)
+
+# walk_parallel() lists directories on every core and returns the entries sorted by path.
+val entries: list[file_entry] = walk_parallel(root)
+for e in entries:
+    print(e.path, e.name, e.size)
+print("file_size:", file_size(root + "/src/deep/data.csv"))
+
+# Entries sort after their parent directory, so removing back to front empties the tree.
+for i in 0..len(entries):
+    remove(entries[len(entries) - 1 - i].path)
+remove(root)
+print("Cleaned up:", exists(root) == false)
+
+try:
+    for e in walk("no_such_directory"):
+        print(e.path)
+catch err:
+    print("Caught missing directory.")
+
+print("Walk test finished.")
@@ -0,0 +1,50 @@
+# examples/v1.1_tests/writer_test.rl
+
+print("Testing buffered writers...")
+
+val path: string = "writer_test_output.txt"
+
+# One open, many buffered writes, one close.
+val out: writer = open_write(path)
+for i in 0..1000:
+    out.write_line("record " + to_string(i))
+out.close()
+val first: string = read_file(path)
+print("Written:", len(first), "bytes, last record:", contains(first, "record 999\n"))
+
+# open_append() keeps what's already there.
+val log: writer = open_append(path)
+log.write("appended")
+log.write(" line\n")
+log.flush()
+print("Flushed before close:", contains(read_file(path), "appended line\n"))
+log.close()
+
+# A background writer hands full buffers to its own thread while the loop goes on.
+val fast: writer = open_write(path, true)
+for i in 0..20000:
+    fast.write_line(to_string(i * i))
+fast.close()
+var count: int = 0
+for line in lines(path):
+    count = count + 1
+print("Background lines:", count)
+
+# Writer handles can be passed around; copies share the file.
+def emit(w: writer, n: int):
+    for i in 0..n:
+        w.write(to_string(i))
+
+val shared: writer = open_write(path)
+emit(shared, 5)
+shared.write_line("")
+shared.close()
+print("Shared:", read_file(path))
+
+try:
+    shared.write("too late")
+catch e:
+    print("Caught write after close.")
+
+remove(path)
+print("Writer test finished.")
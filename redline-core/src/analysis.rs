@@ -0,0 +1,706 @@
+//! Lightweight dataflow queries over the AST used by codegen to pick
+//! cheaper C++ lowerings (pass-by-reference, moves) without changing behaviour.
+use crate::ast::{Statement, Expression, ClassMember, Literal, Parameter, Type};
+use std::collections::{HashMap, HashSet};
+
+/// Builtins that modify the list passed as their first argument.
+const MUTATING_BUILTINS: &[&str] = &["append", "sort", "reverse", "reserve", "resize", "clear", "shrink_to_fit"];
+
+/// Builtins that never change the length of a list, including one passed to them.
+const LENGTH_PRESERVING_BUILTINS: &[&str] = &["len", "sort", "reverse", "find", "join", "contains", "to_string", "unsafe_get", "print",
+    "sum", "dot", "min", "max", "scale", "map_sqrt", "reserve", "shrink_to_fit", "capacity", "add", "sub", "mul",
+    "sqrt", "sin", "cos", "tan", "pow", "exp", "log", "log10", "abs", "floor", "ceil", "round",
+    "to_int", "to_float", "try_to_int", "try_to_float", "split", "split_view", "tokenize", "random_int", "random_float"];
+
+/// Builtins that keep the argument at the given position, so a value moved
+/// into it isn't copied.
+const STORING_BUILTINS: &[(&str, usize)] = &[("append", 1)];
+
+/// For each function, and each class's constructor (keyed by class name):
+/// whether the parameter at each position takes its argument by value. A
+/// local can only be moved into those; `std::move` into a `mut` parameter
+/// wouldn't bind to its reference.
+pub type ByValueArgs = HashMap<String, Vec<bool>>;
+
+/// Counts how many times `name` is referenced inside an expression.
+pub fn expression_uses(expr: &Expression, name: &str) -> usize {
+    match expr {
+        Expression::Identifier(n) => if n == name { 1 } else { 0 },
+        Expression::Literal(_) | Expression::This => 0,
+        Expression::ListLiteral(elements) | Expression::FormatString(elements) => elements.iter().map(|e| expression_uses(e, name)).sum(),
+        Expression::DictLiteral(entries) => entries.iter().map(|(k, v)| expression_uses(k, name) + expression_uses(v, name)).sum(),
+        Expression::BinaryOp { left, right, .. } => expression_uses(left, name) + expression_uses(right, name),
+        Expression::Call { callee, args } => expression_uses(callee, name) + args.iter().map(|a| expression_uses(a, name)).sum::<usize>(),
+        Expression::Index { list, index } | Expression::InRangeIndex { list, index } => expression_uses(list, name) + expression_uses(index, name),
+        Expression::Get { object, .. } => expression_uses(object, name),
+        Expression::New { args, .. } => args.iter().map(|a| expression_uses(a, name)).sum(),
+        Expression::Move(inner) | Expression::Spawn(inner) | Expression::ListWithCapacity { capacity: inner, .. } => expression_uses(inner, name),
+    }
+}
+
+/// Counts how many times `name` is referenced inside a statement (including nested blocks).
+pub fn statement_uses(stmt: &Statement, name: &str) -> usize {
+    match stmt {
+        Statement::Declaration { initializer, .. } => expression_uses(initializer, name),
+        Statement::Assignment { target, value } => expression_uses(target, name) + expression_uses(value, name),
+        Statement::If { condition, consequence, alternative } => {
+            expression_uses(condition, name) + block_uses(consequence, name) + alternative.as_ref().map_or(0, |alt| block_uses(alt, name))
+        }
+        Statement::While { condition, body } => expression_uses(condition, name) + block_uses(body, name),
+        Statement::For { start, end, parallel, body, .. } => {
+            let reduces = parallel.as_ref().and_then(|p| p.reduction.as_ref()).map_or(false, |(_, target)| target == name);
+            expression_uses(start, name) + expression_uses(end, name) + block_uses(body, name) + reduces as usize
+        }
+        Statement::ForEach { iterable, body, .. } => expression_uses(iterable, name) + block_uses(body, name),
+        Statement::Print(args) => args.iter().map(|a| expression_uses(a, name)).sum(),
+        Statement::Expression(expr) => expression_uses(expr, name),
+        Statement::Return(expr) => expr.as_ref().map_or(0, |e| expression_uses(e, name)),
+        Statement::TryCatch { try_block, catch_block, .. } => block_uses(try_block, name) + block_uses(catch_block, name),
+        Statement::Arena { initial_size, body } => initial_size.as_ref().map_or(0, |e| expression_uses(e, name)) + block_uses(body, name),
+        Statement::Lock { mutex, body } => expression_uses(mutex, name) + block_uses(body, name),
+        Statement::FunctionDefinition { body, .. } => block_uses(body, name),
+        Statement::Class { members, .. } => members.iter().map(|m| match m {
+            ClassMember::Variable(s) | ClassMember::Method(s) | ClassMember::Constructor(s) => statement_uses(s, name),
+        }).sum(),
+        Statement::Import(_) | Statement::Break | Statement::Continue | Statement::Line { .. } | Statement::ProfileScope { .. } => 0,
+    }
+}
+
+pub fn block_uses(block: &[Statement], name: &str) -> usize {
+    block.iter().map(|s| statement_uses(s, name)).sum()
+}
+
+/// The variable an assignment target ultimately writes into, looking through
+/// indexing (`xs[i][j] = ...` writes `xs`). Member writes (`p.x = ...`) go
+/// through the object's pointer and don't modify the variable itself, but a
+/// member of an element (`ps[i].x = ...`) may be part of a struct stored in `ps`.
+fn written_variable(target: &Expression) -> Option<&str> {
+    match target {
+        Expression::Identifier(n) => Some(n),
+        Expression::Index { list, .. } | Expression::InRangeIndex { list, .. } => written_variable(list),
+        Expression::Get { object, .. } if matches!(&**object, Expression::Index { .. } | Expression::InRangeIndex { .. } | Expression::Get { .. }) => {
+            written_variable(object)
+        }
+        _ => None,
+    }
+}
+
+/// The variable an expression reads an object from, looking through member
+/// access and indexing (`p.pos.x` and `ps[i].x` both come from `p`/`ps`).
+fn object_root(expr: &Expression) -> Option<&str> {
+    match expr {
+        Expression::Identifier(n) => Some(n),
+        Expression::Index { list, .. } | Expression::InRangeIndex { list, .. } => object_root(list),
+        Expression::Get { object, .. } => object_root(object),
+        _ => None,
+    }
+}
+
+fn expression_touches_members(expr: &Expression, name: &str) -> bool {
+    match expr {
+        Expression::Call { callee, args } => {
+            let is_method_call = matches!(&**callee, Expression::Get { object, .. } if object_root(object) == Some(name));
+            is_method_call || expression_touches_members(callee, name) || args.iter().any(|a| expression_touches_members(a, name))
+        }
+        Expression::Move(inner) | Expression::Spawn(inner) | Expression::ListWithCapacity { capacity: inner, .. } => expression_touches_members(inner, name),
+        Expression::ListLiteral(elements) | Expression::FormatString(elements) => elements.iter().any(|e| expression_touches_members(e, name)),
+        Expression::DictLiteral(entries) => entries.iter().any(|(k, v)| expression_touches_members(k, name) || expression_touches_members(v, name)),
+        Expression::BinaryOp { left, right, .. } => expression_touches_members(left, name) || expression_touches_members(right, name),
+        Expression::Index { list, index } | Expression::InRangeIndex { list, index } => {
+            expression_touches_members(list, name) || expression_touches_members(index, name)
+        }
+        Expression::Get { object, .. } => expression_touches_members(object, name),
+        Expression::New { args, .. } => args.iter().any(|a| expression_touches_members(a, name)),
+        Expression::Identifier(_) | Expression::Literal(_) | Expression::This => false,
+    }
+}
+
+/// True if `block` may modify the object held in `name` without reassigning
+/// the variable: by writing one of its fields or calling one of its methods.
+pub fn members_mutated(block: &[Statement], name: &str) -> bool {
+    block.iter().any(|stmt| match stmt {
+        Statement::Assignment { target, value } => {
+            (matches!(target, Expression::Get { .. }) && object_root(target) == Some(name))
+                || expression_touches_members(target, name) || expression_touches_members(value, name)
+        }
+        Statement::Declaration { initializer, .. } => expression_touches_members(initializer, name),
+        Statement::If { condition, consequence, alternative } => {
+            expression_touches_members(condition, name) || members_mutated(consequence, name) || alternative.as_ref().map_or(false, |alt| members_mutated(alt, name))
+        }
+        Statement::While { condition, body } => expression_touches_members(condition, name) || members_mutated(body, name),
+        Statement::For { start, end, body, .. } => {
+            expression_touches_members(start, name) || expression_touches_members(end, name) || members_mutated(body, name)
+        }
+        Statement::ForEach { is_mutable, iterable, body, .. } => {
+            (*is_mutable && matches!(iterable, Expression::Get { .. }) && object_root(iterable) == Some(name))
+                || expression_touches_members(iterable, name) || members_mutated(body, name)
+        }
+        Statement::Print(args) => args.iter().any(|a| expression_touches_members(a, name)),
+        Statement::Expression(expr) => expression_touches_members(expr, name),
+        Statement::Return(expr) => expr.as_ref().map_or(false, |e| expression_touches_members(e, name)),
+        Statement::TryCatch { try_block, catch_block, .. } => members_mutated(try_block, name) || members_mutated(catch_block, name),
+        Statement::Arena { initial_size, body } => {
+            initial_size.as_ref().map_or(false, |e| expression_touches_members(e, name)) || members_mutated(body, name)
+        }
+        Statement::Lock { mutex, body } => expression_touches_members(mutex, name) || members_mutated(body, name),
+        _ => false,
+    })
+}
+
+fn expression_mutates(expr: &Expression, name: &str) -> bool {
+    match expr {
+        Expression::Call { callee, args } => {
+            let mutates_first_arg = matches!(&**callee, Expression::Identifier(f) if MUTATING_BUILTINS.contains(&f.as_str()))
+                && args.first().and_then(written_variable) == Some(name);
+            mutates_first_arg || expression_mutates(callee, name) || args.iter().any(|a| expression_mutates(a, name))
+        }
+        // Moving out of a variable leaves it modified.
+        Expression::Move(inner) => written_variable(inner) == Some(name) || expression_mutates(inner, name),
+        Expression::Spawn(inner) | Expression::ListWithCapacity { capacity: inner, .. } => expression_mutates(inner, name),
+        Expression::ListLiteral(elements) | Expression::FormatString(elements) => elements.iter().any(|e| expression_mutates(e, name)),
+        Expression::DictLiteral(entries) => entries.iter().any(|(k, v)| expression_mutates(k, name) || expression_mutates(v, name)),
+        Expression::BinaryOp { left, right, .. } => expression_mutates(left, name) || expression_mutates(right, name),
+        Expression::Index { list, index } | Expression::InRangeIndex { list, index } => expression_mutates(list, name) || expression_mutates(index, name),
+        Expression::Get { object, .. } => expression_mutates(object, name),
+        Expression::New { args, .. } => args.iter().any(|a| expression_mutates(a, name)),
+        Expression::Identifier(_) | Expression::Literal(_) | Expression::This => false,
+    }
+}
+
+/// True if any statement in `block` may modify the variable `name`.
+pub fn is_mutated(block: &[Statement], name: &str) -> bool {
+    block.iter().any(|stmt| match stmt {
+        Statement::Assignment { target, value } => {
+            written_variable(target) == Some(name) || expression_mutates(target, name) || expression_mutates(value, name)
+        }
+        Statement::Declaration { initializer, .. } => expression_mutates(initializer, name),
+        Statement::If { condition, consequence, alternative } => {
+            expression_mutates(condition, name) || is_mutated(consequence, name) || alternative.as_ref().map_or(false, |alt| is_mutated(alt, name))
+        }
+        Statement::While { condition, body } => expression_mutates(condition, name) || is_mutated(body, name),
+        Statement::For { iterator, start, end, parallel, body } => {
+            iterator == name || parallel.as_ref().and_then(|p| p.reduction.as_ref()).map_or(false, |(_, target)| target == name) || expression_mutates(start, name) || expression_mutates(end, name) || is_mutated(body, name)
+        }
+        // `for mut x in xs:` can write to every element of `xs` through `x`.
+        Statement::ForEach { iterator, value, is_mutable, iterable, body } => {
+            iterator == name || value.as_deref() == Some(name) || (*is_mutable && written_variable(iterable) == Some(name))
+                || expression_mutates(iterable, name) || is_mutated(body, name)
+        }
+        Statement::Print(args) => args.iter().any(|a| expression_mutates(a, name)),
+        Statement::Expression(expr) => expression_mutates(expr, name),
+        Statement::Return(expr) => expr.as_ref().map_or(false, |e| expression_mutates(e, name)),
+        Statement::TryCatch { try_block, catch_block, .. } => is_mutated(try_block, name) || is_mutated(catch_block, name),
+        Statement::Arena { initial_size, body } => {
+            initial_size.as_ref().map_or(false, |e| expression_mutates(e, name)) || is_mutated(body, name)
+        }
+        Statement::Lock { mutex, body } => expression_mutates(mutex, name) || is_mutated(body, name),
+        _ => false,
+    })
+}
+
+/// Wraps a direct use of `name` in `Expression::Move` if it sits in a position
+/// where the value is handed off whole: the expression itself, an element of a
+/// list literal, or an argument of a call / `new` (recursively) that `sinks` says
+/// is taken by value. Any other argument may be a reference, which a moved value
+/// can't bind to if it's a non-const one (`append(xs, v)`, a `mut` parameter).
+fn move_in_expression(expr: &mut Expression, name: &str, sinks: &ByValueArgs) -> bool {
+    match expr {
+        Expression::Identifier(n) if n == name => {
+            *expr = Expression::Move(Box::new(Expression::Identifier(name.to_string())));
+            true
+        }
+        Expression::Call { callee, args } => {
+            let function = match &**callee {
+                Expression::Identifier(f) => Some(f.as_str()),
+                _ => None,
+            };
+            move_in_arguments(args, function, name, sinks)
+        }
+        Expression::New { class_name, args } => move_in_arguments(args, Some(class_name.as_str()), name, sinks),
+        Expression::ListLiteral(elements) => elements.iter_mut().any(|e| move_in_expression(e, name, sinks)),
+        _ => false,
+    }
+}
+
+fn move_in_arguments(args: &mut [Expression], function: Option<&str>, name: &str, sinks: &ByValueArgs) -> bool {
+    args.iter_mut().enumerate().any(|(i, arg)| {
+        let hands_off = match (arg as &Expression, function) {
+            (Expression::Identifier(n), Some(f)) if n == name => {
+                STORING_BUILTINS.contains(&(f, i)) || sinks.get(f).map_or(false, |by_value| by_value.get(i) == Some(&true))
+            }
+            (Expression::Identifier(n), None) if n == name => false,
+            _ => true,
+        };
+        hands_off && move_in_expression(arg, name, sinks)
+    })
+}
+
+/// Inserts `std::move` at the last use of `name` in `block`, when that use is
+/// provably the final read on every path: not inside a loop or a `try`, and the
+/// only reference to `name` in its statement (so argument evaluation order can't
+/// observe a moved-from value). `sinks` is as for `move_in_expression`.
+pub fn move_last_use(block: &mut [Statement], name: &str, sinks: &ByValueArgs) {
+    let view_variables = view_variables(block);
+    move_last_use_with(block, name, &view_variables, sinks);
+}
+
+/// `move_last_use`, with the function's view-typed variables already collected.
+/// A use of a view taken from `name` counts as a use of `name`: moving the
+/// string out would leave the view pointing into the moved-from buffer.
+fn move_last_use_with(block: &mut [Statement], name: &str, view_variables: &HashSet<String>, sinks: &ByValueArgs) {
+    let views = views_into(block, name, view_variables);
+    move_unviewed_last_use(block, name, &views, sinks);
+}
+
+fn move_unviewed_last_use(block: &mut [Statement], name: &str, views: &HashSet<String>, sinks: &ByValueArgs) {
+    let last = match block.iter().rposition(|s| statement_uses(s, name) > 0) {
+        Some(i) => i,
+        None => return,
+    };
+    if views.iter().any(|view| block[last..].iter().any(|s| statement_uses(s, view) > 0)) {
+        return;
+    }
+    let stmt = &mut block[last];
+    match stmt {
+        Statement::If { consequence, alternative, .. } => {
+            move_unviewed_last_use(consequence, name, views, sinks);
+            if let Some(alt) = alternative {
+                move_unviewed_last_use(alt, name, views, sinks);
+            }
+            return;
+        }
+        // The block runs exactly once, so its last use is the statement's last use.
+        Statement::Arena { body, .. } | Statement::Lock { body, .. } => {
+            move_unviewed_last_use(body, name, views, sinks);
+            return;
+        }
+        Statement::While { .. } | Statement::For { .. } | Statement::ForEach { .. } | Statement::TryCatch { .. } => return,
+        _ => {}
+    }
+    if statement_uses(stmt, name) != 1 {
+        return;
+    }
+    match stmt {
+        Statement::Declaration { initializer, .. } => { move_in_expression(initializer, name, sinks); }
+        Statement::Assignment { value, .. } => { move_in_expression(value, name, sinks); }
+        // `return local` already moves (or elides the copy); std::move would only stop the elision.
+        Statement::Return(Some(Expression::Identifier(_))) => {}
+        Statement::Return(Some(expr)) | Statement::Expression(expr) => { move_in_expression(expr, name, sinks); }
+        _ => {}
+    }
+}
+
+/// The variables declared in `block`, or in a block nested in it, whose type can hold a view.
+fn view_variables(block: &[Statement]) -> HashSet<String> {
+    let mut names = HashSet::new();
+    collect_view_variables(block, &mut names);
+    names
+}
+
+fn collect_view_variables(block: &[Statement], names: &mut HashSet<String>) {
+    for stmt in block {
+        match stmt {
+            Statement::Declaration { name, data_type, .. } if data_type.holds_view() => { names.insert(name.clone()); }
+            Statement::If { consequence, alternative, .. } => {
+                collect_view_variables(consequence, names);
+                if let Some(alt) = alternative {
+                    collect_view_variables(alt, names);
+                }
+            }
+            Statement::TryCatch { try_block, catch_block, .. } => {
+                collect_view_variables(try_block, names);
+                collect_view_variables(catch_block, names);
+            }
+            Statement::While { body, .. } | Statement::For { body, .. } | Statement::ForEach { body, .. }
+            | Statement::Arena { body, .. } | Statement::Lock { body, .. } => collect_view_variables(body, names),
+            _ => {}
+        }
+    }
+}
+
+/// The variables in `block` that may end up viewing into `name`'s buffer, directly
+/// (`val v: str_view = s`, `for tok in split_view(s, ","):`) or through another
+/// such variable (`append(views, tok)`). Worked out to a fixed point, since a
+/// view can be passed along more than once.
+fn views_into(block: &[Statement], name: &str, view_variables: &HashSet<String>) -> HashSet<String> {
+    let mut sources: HashSet<String> = HashSet::from([name.to_string()]);
+    loop {
+        let before = sources.len();
+        collect_views(block, view_variables, &mut sources);
+        if sources.len() == before {
+            break;
+        }
+    }
+    sources.remove(name);
+    sources
+}
+
+fn collect_views(block: &[Statement], view_variables: &HashSet<String>, sources: &mut HashSet<String>) {
+    let mentions_source = |expr: &Expression, sources: &HashSet<String>| sources.iter().any(|s| expression_uses(expr, s) > 0);
+    for stmt in block {
+        match stmt {
+            Statement::Declaration { name, data_type, initializer, .. } => {
+                if data_type.holds_view() && mentions_source(initializer, sources) {
+                    sources.insert(name.clone());
+                }
+                collect_stored_views(initializer, view_variables, sources);
+            }
+            Statement::Assignment { target, value } => {
+                if let Some(written) = written_variable(target) {
+                    if view_variables.contains(written) && mentions_source(value, sources) {
+                        sources.insert(written.to_string());
+                    }
+                }
+                collect_stored_views(value, view_variables, sources);
+            }
+            Statement::Expression(expr) => collect_stored_views(expr, view_variables, sources),
+            // A loop over a source yields views into it (or references to its elements).
+            Statement::ForEach { iterator, value, iterable, body, .. } => {
+                if mentions_source(iterable, sources) {
+                    sources.insert(iterator.clone());
+                    if let Some(value) = value {
+                        sources.insert(value.clone());
+                    }
+                }
+                collect_views(body, view_variables, sources);
+            }
+            Statement::If { consequence, alternative, .. } => {
+                collect_views(consequence, view_variables, sources);
+                if let Some(alt) = alternative {
+                    collect_views(alt, view_variables, sources);
+                }
+            }
+            Statement::TryCatch { try_block, catch_block, .. } => {
+                collect_views(try_block, view_variables, sources);
+                collect_views(catch_block, view_variables, sources);
+            }
+            Statement::While { body, .. } | Statement::For { body, .. }
+            | Statement::Arena { body, .. } | Statement::Lock { body, .. } => collect_views(body, view_variables, sources),
+            _ => {}
+        }
+    }
+}
+
+/// A call like `append(views, tok)` stores a view in its first argument.
+fn collect_stored_views(expr: &Expression, view_variables: &HashSet<String>, sources: &mut HashSet<String>) {
+    if let Expression::Call { args, .. } = expr {
+        if let Some(Expression::Identifier(target)) = args.first() {
+            if view_variables.contains(target) && args[1..].iter().any(|a| sources.iter().any(|s| expression_uses(a, s) > 0)) {
+                sources.insert(target.clone());
+            }
+        }
+        for arg in args {
+            collect_stored_views(arg, view_variables, sources);
+        }
+    }
+}
+
+/// Moves each local declared in `block`, or in a block nested in it, at its
+/// last use, so a list or string built up and then handed to its final owner
+/// (appended, assigned, returned inside a call) isn't deep-copied.
+pub fn move_dead_locals(block: &mut [Statement], sinks: &ByValueArgs) {
+    let view_variables = view_variables(block);
+    move_dead_locals_with(block, sinks, &view_variables);
+}
+
+fn move_dead_locals_with(block: &mut [Statement], sinks: &ByValueArgs, view_variables: &HashSet<String>) {
+    for i in 0..block.len() {
+        if let Statement::Declaration { name, data_type, .. } = &block[i] {
+            if data_type.is_movable() {
+                let name = name.clone();
+                move_last_use_with(&mut block[i + 1..], &name, view_variables, sinks);
+            }
+        }
+        match &mut block[i] {
+            Statement::If { consequence, alternative, .. } => {
+                move_dead_locals_with(consequence, sinks, view_variables);
+                if let Some(alt) = alternative {
+                    move_dead_locals_with(alt, sinks, view_variables);
+                }
+            }
+            Statement::TryCatch { try_block, catch_block, .. } => {
+                move_dead_locals_with(try_block, sinks, view_variables);
+                move_dead_locals_with(catch_block, sinks, view_variables);
+            }
+            Statement::While { body, .. } | Statement::For { body, .. } | Statement::ForEach { body, .. }
+            | Statement::Arena { body, .. } | Statement::Lock { body, .. } => move_dead_locals_with(body, sinks, view_variables),
+            _ => {}
+        }
+    }
+}
+
+/// True if `body` has a `return`, or a `break` that would leave this loop.
+/// A `parallel for` runs its body in chunks on other threads, so neither can work there.
+pub fn escapes_loop(body: &[Statement]) -> bool {
+    body.iter().any(|stmt| match stmt {
+        Statement::Return(_) | Statement::Break => true,
+        Statement::If { consequence, alternative, .. } => escapes_loop(consequence) || alternative.as_ref().map_or(false, |alt| escapes_loop(alt)),
+        Statement::TryCatch { try_block, catch_block, .. } => escapes_loop(try_block) || escapes_loop(catch_block),
+        Statement::Arena { body, .. } | Statement::Lock { body, .. } => escapes_loop(body),
+        // A nested loop owns its breaks; only a return gets out of it.
+        Statement::While { body, .. } | Statement::For { body, .. } | Statement::ForEach { body, .. } => returns(body),
+        _ => false,
+    })
+}
+
+fn returns(block: &[Statement]) -> bool {
+    block.iter().any(|stmt| match stmt {
+        Statement::Return(_) => true,
+        Statement::If { consequence, alternative, .. } => returns(consequence) || alternative.as_ref().map_or(false, |alt| returns(alt)),
+        Statement::TryCatch { try_block, catch_block, .. } => returns(try_block) || returns(catch_block),
+        Statement::While { body, .. } | Statement::For { body, .. } | Statement::ForEach { body, .. }
+        | Statement::Arena { body, .. } | Statement::Lock { body, .. } => returns(body),
+        _ => false,
+    })
+}
+
+/// True if `block` declares a variable (or loop iterator) called `name`, which
+/// would shadow the outer one.
+fn declares(block: &[Statement], name: &str) -> bool {
+    block.iter().any(|stmt| match stmt {
+        Statement::Declaration { name: n, .. } => n == name,
+        Statement::For { iterator, body, .. } => iterator == name || declares(body, name),
+        Statement::ForEach { iterator, value, body, .. } => iterator == name || value.as_deref() == Some(name) || declares(body, name),
+        Statement::If { consequence, alternative, .. } => declares(consequence, name) || alternative.as_ref().map_or(false, |alt| declares(alt, name)),
+        Statement::While { body, .. } | Statement::Arena { body, .. } | Statement::Lock { body, .. } => declares(body, name),
+        Statement::TryCatch { try_block, catch_var, catch_block } => catch_var == name || declares(try_block, name) || declares(catch_block, name),
+        _ => false,
+    })
+}
+
+/// `aliases` says whether an expression may denote the list in question, so that
+/// appending to it, moving it or assigning it resizes the list.
+fn expression_may_resize(expr: &Expression, aliases: &dyn Fn(&Expression) -> bool, declared: &HashSet<String>) -> bool {
+    let resize = |e: &Expression| expression_may_resize(e, aliases, declared);
+    match expr {
+        Expression::Call { callee, args } => {
+            // Only a builtin's effect is known. Anything else (a user function, a method, a
+            // builtin's name reused by the program) might reach the list through `this` or
+            // an object it was handed.
+            let builtin = match &**callee {
+                Expression::Identifier(f) if !declared.contains(f) => Some(f.as_str()),
+                _ => None,
+            };
+            let resizes = match builtin {
+                Some(f) if LENGTH_PRESERVING_BUILTINS.contains(&f) => false,
+                Some(f) if MUTATING_BUILTINS.contains(&f) => args.iter().any(|a| aliases(a)),
+                _ => true,
+            };
+            resizes || resize(callee) || args.iter().any(resize)
+        }
+        Expression::Move(inner) => aliases(inner) || resize(inner),
+        Expression::Spawn(inner) | Expression::ListWithCapacity { capacity: inner, .. } => resize(inner),
+        Expression::ListLiteral(elements) | Expression::FormatString(elements) => elements.iter().any(resize),
+        Expression::DictLiteral(entries) => entries.iter().any(|(k, v)| resize(k) || resize(v)),
+        Expression::BinaryOp { left, right, .. } => resize(left) || resize(right),
+        Expression::Index { list: l, index } | Expression::InRangeIndex { list: l, index } => resize(l) || resize(index),
+        Expression::Get { object, .. } => resize(object),
+        // A constructor is user code too.
+        Expression::New { .. } => true,
+        Expression::Identifier(_) | Expression::Literal(_) | Expression::This => false,
+    }
+}
+
+/// True if anything in `block` may change the length of the list `aliases`
+/// recognises. Writing to an element (`xs[i] = v`) doesn't; reassigning,
+/// appending, moving or calling anything but a known builtin does.
+fn may_resize(block: &[Statement], aliases: &dyn Fn(&Expression) -> bool, declared: &HashSet<String>) -> bool {
+    let resize = |e: &Expression| expression_may_resize(e, aliases, declared);
+    let block_resizes = |b: &[Statement]| may_resize(b, aliases, declared);
+    block.iter().any(|stmt| match stmt {
+        Statement::Assignment { target, value } => aliases(target) || resize(target) || resize(value),
+        Statement::Declaration { initializer, .. } => resize(initializer),
+        Statement::If { condition, consequence, alternative } => {
+            resize(condition) || block_resizes(consequence) || alternative.as_deref().map_or(false, block_resizes)
+        }
+        Statement::While { condition, body } => resize(condition) || block_resizes(body),
+        Statement::For { start, end, body, .. } => resize(start) || resize(end) || block_resizes(body),
+        Statement::ForEach { is_mutable, iterable, body, .. } => (*is_mutable && aliases(iterable)) || resize(iterable) || block_resizes(body),
+        Statement::Print(args) => args.iter().any(resize),
+        Statement::Expression(expr) => resize(expr),
+        Statement::Return(expr) => expr.as_ref().map_or(false, resize),
+        Statement::TryCatch { try_block, catch_block, .. } => block_resizes(try_block) || block_resizes(catch_block),
+        Statement::Arena { initial_size, body } => initial_size.as_ref().map_or(false, resize) || block_resizes(body),
+        Statement::Lock { mutex, body } => resize(mutex) || block_resizes(body),
+        _ => false,
+    })
+}
+
+/// For a loop over the parameter `list`: true if writing `expr` might write the
+/// caller's list, which may also have been passed as another parameter
+/// (`f(xs, xs)`) or be reachable through an object's field. Only the function's
+/// own locals, and elements of parameters whose elements can't hold a list, are
+/// known to be elsewhere.
+fn may_alias_parameter(expr: &Expression, body: &[Statement], locals: &[String], params: &[Parameter]) -> bool {
+    let holds_no_lists = |t: &Type| match t {
+        Type::List(element) | Type::Dict(_, element) | Type::OrderedDict(_, element) => {
+            matches!(**element, Type::Int | Type::Float | Type::Bool | Type::String | Type::StrView)
+        }
+        _ => false,
+    };
+    match expr {
+        Expression::Identifier(n) => params.iter().any(|p| &p.name == n) || (!locals.contains(n) && !declares(body, n)),
+        Expression::Index { list, .. } | Expression::InRangeIndex { list, .. } => match &**list {
+            Expression::Identifier(n) if params.iter().any(|p| &p.name == n && holds_no_lists(&p.data_type)) => false,
+            _ => may_alias_parameter(list, body, locals, params),
+        },
+        Expression::Get { .. } | Expression::This => true,
+        _ => false,
+    }
+}
+
+/// For `for i in start..len(xs):`, returns `xs` if every `xs[i]` in the body is
+/// provably in bounds: `xs` is one of `locals` (a bare name in a method may be a
+/// field, which other methods can resize), `start` is a non-negative literal, and
+/// the body never reassigns `i`, never changes the length of `xs`, and shadows
+/// neither name. If `xs` is one of the function's `params`, the body may not
+/// resize anything that could be the same list either. `declared` holds the
+/// functions and methods of every module in the program, including the ones
+/// this module imports.
+fn in_range_list<'a>(iterator: &str, start: &Expression, end: &'a Expression, body: &[Statement], locals: &[String], params: &[Parameter], declared: &HashSet<String>) -> Option<&'a str> {
+    if !matches!(start, Expression::Literal(Literal::Int(n)) if *n >= 0) {
+        return None;
+    }
+    let list = match end {
+        Expression::Call { callee, args } if matches!(&**callee, Expression::Identifier(f) if f == "len") => match args.as_slice() {
+            [Expression::Identifier(list)] => list.as_str(),
+            _ => return None,
+        },
+        _ => return None,
+    };
+    if !locals.iter().any(|l| l == list) || list == iterator || is_mutated(body, iterator)
+        || declares(body, iterator) || declares(body, list) {
+        return None;
+    }
+    let is_list = |e: &Expression| matches!(e, Expression::Identifier(n) if n == list);
+    let resized = if params.iter().any(|p| p.name == list) {
+        may_resize(body, &|e| is_list(e) || may_alias_parameter(e, body, locals, params), declared)
+    } else {
+        may_resize(body, &is_list, declared)
+    };
+    if resized {
+        return None;
+    }
+    Some(list)
+}
+
+/// Rewrites the `xs[i]` accesses of every loop in a function body that
+/// `in_range_list` proves in bounds. `locals` starts as the names of the
+/// function's `params` and grows with the declarations seen so far.
+pub fn mark_in_range_loops(block: &mut [Statement], locals: &mut Vec<String>, params: &[Parameter], declared: &HashSet<String>) {
+    let scope = locals.len();
+    for stmt in block.iter_mut() {
+        match stmt {
+            Statement::Declaration { name, .. } => locals.push(name.clone()),
+            Statement::For { iterator, start, end, body, .. } => {
+                if let Some(list) = in_range_list(iterator, start, end, body, locals, params, declared) {
+                    mark_in_range(body, list, iterator);
+                }
+                mark_in_range_loops(body, locals, params, declared);
+            }
+            Statement::If { consequence, alternative, .. } => {
+                mark_in_range_loops(consequence, locals, params, declared);
+                if let Some(alt) = alternative {
+                    mark_in_range_loops(alt, locals, params, declared);
+                }
+            }
+            Statement::While { body, .. } | Statement::ForEach { body, .. } | Statement::Arena { body, .. } | Statement::Lock { body, .. } => {
+                mark_in_range_loops(body, locals, params, declared);
+            }
+            Statement::TryCatch { try_block, catch_block, .. } => {
+                mark_in_range_loops(try_block, locals, params, declared);
+                mark_in_range_loops(catch_block, locals, params, declared);
+            }
+            _ => {}
+        }
+    }
+    locals.truncate(scope);
+}
+
+fn mark_in_range_expression(expr: &mut Expression, list: &str, iterator: &str) {
+    match expr {
+        Expression::Index { list: l, index } => {
+            mark_in_range_expression(l, list, iterator);
+            mark_in_range_expression(index, list, iterator);
+            let proven = matches!(&**l, Expression::Identifier(n) if n == list) && matches!(&**index, Expression::Identifier(n) if n == iterator);
+            if proven {
+                let l = std::mem::replace(l, Box::new(Expression::This));
+                let index = std::mem::replace(index, Box::new(Expression::This));
+                *expr = Expression::InRangeIndex { list: l, index };
+            }
+        }
+        Expression::InRangeIndex { list: l, index } => {
+            mark_in_range_expression(l, list, iterator);
+            mark_in_range_expression(index, list, iterator);
+        }
+        Expression::Call { callee, args } => {
+            mark_in_range_expression(callee, list, iterator);
+            args.iter_mut().for_each(|a| mark_in_range_expression(a, list, iterator));
+        }
+        Expression::ListLiteral(elements) | Expression::FormatString(elements) | Expression::New { args: elements, .. } => {
+            elements.iter_mut().for_each(|e| mark_in_range_expression(e, list, iterator));
+        }
+        Expression::DictLiteral(entries) => entries.iter_mut().for_each(|(k, v)| {
+            mark_in_range_expression(k, list, iterator);
+            mark_in_range_expression(v, list, iterator);
+        }),
+        Expression::BinaryOp { left, right, .. } => {
+            mark_in_range_expression(left, list, iterator);
+            mark_in_range_expression(right, list, iterator);
+        }
+        Expression::Get { object, .. } => mark_in_range_expression(object, list, iterator),
+        Expression::Move(inner) | Expression::Spawn(inner) | Expression::ListWithCapacity { capacity: inner, .. } => mark_in_range_expression(inner, list, iterator),
+        Expression::Identifier(_) | Expression::Literal(_) | Expression::This => {}
+    }
+}
+
+/// Rewrites every `list[iterator]` in `block` to `Expression::InRangeIndex`.
+/// Only valid for a block `in_range_list` accepted.
+fn mark_in_range(block: &mut [Statement], list: &str, iterator: &str) {
+    for stmt in block.iter_mut() {
+        match stmt {
+            Statement::Declaration { initializer, .. } => mark_in_range_expression(initializer, list, iterator),
+            Statement::Assignment { target, value } => {
+                mark_in_range_expression(target, list, iterator);
+                mark_in_range_expression(value, list, iterator);
+            }
+            Statement::If { condition, consequence, alternative } => {
+                mark_in_range_expression(condition, list, iterator);
+                mark_in_range(consequence, list, iterator);
+                if let Some(alt) = alternative {
+                    mark_in_range(alt, list, iterator);
+                }
+            }
+            Statement::While { condition, body } => {
+                mark_in_range_expression(condition, list, iterator);
+                mark_in_range(body, list, iterator);
+            }
+            Statement::For { start, end, body, .. } => {
+                mark_in_range_expression(start, list, iterator);
+                mark_in_range_expression(end, list, iterator);
+                mark_in_range(body, list, iterator);
+            }
+            Statement::ForEach { iterable, body, .. } => {
+                mark_in_range_expression(iterable, list, iterator);
+                mark_in_range(body, list, iterator);
+            }
+            Statement::Print(args) => args.iter_mut().for_each(|a| mark_in_range_expression(a, list, iterator)),
+            Statement::Expression(expr) | Statement::Return(Some(expr)) => mark_in_range_expression(expr, list, iterator),
+            Statement::TryCatch { try_block, catch_block, .. } => {
+                mark_in_range(try_block, list, iterator);
+                mark_in_range(catch_block, list, iterator);
+            }
+            Statement::Arena { initial_size, body } => {
+                if let Some(size) = initial_size {
+                    mark_in_range_expression(size, list, iterator);
+                }
+                mark_in_range(body, list, iterator);
+            }
+            Statement::Lock { mutex, body } => {
+                mark_in_range_expression(mutex, list, iterator);
+                mark_in_range(body, list, iterator);
+            }
+            _ => {}
+        }
+    }
+}
@@ -8,11 +8,21 @@ pub enum Type {
     Int,
     Float,
     String,
+    StrView, // Non-owning view into a string: str_view
     Bool,
     Void, // Represents the absence of a return value
     List(Box<Type>),
-    Dict(Box<Type>, Box<Type>), // Dictionary type: dict[Key, Value]
-    Class(String), // Represents a user-defined class type
+    Dict(Box<Type>, Box<Type>), // Dictionary type: dict[Key, Value], backed by a hash map
+    OrderedDict(Box<Type>, Box<Type>), // Sorted dictionary type: ordered_dict[Key, Value]
+    MappedFile, // Read-only memory-mapped view of a file: mapped_file
+    FileEntry, // A path with its type, size and mtime, as yielded by walk(): file_entry
+    Writer, // Buffered handle to a file opened for writing: writer
+    Task(Box<Type>), // Handle to a spawned function returning T: task[T]
+    Mutex, // A lock used with `lock m:` blocks
+    Stopwatch, // Monotonic timer: stopwatch
+    Atomic(Box<Type>), // Lock-free shared value: atomic[T]
+    Channel(Box<Type>), // Bounded multi-producer/multi-consumer queue: channel[T]
+    Class(String), // Represents a user-defined class, struct or unique class type
 }
 
 impl ToString for Type {
@@ -21,22 +31,80 @@ impl ToString for Type {
             Type::Int => "int".to_string(),
             Type::Float => "double".to_string(),
             Type::String => "std::string".to_string(),
+            Type::StrView => "std::string_view".to_string(),
             Type::Bool => "bool".to_string(),
             Type::Void => "void".to_string(),
-            Type::List(inner) => {
-                // If the list contains class objects, it's a list of smart pointers.
-                if let Type::Class(class_name) = &**inner {
-                    format!("std::vector<std::shared_ptr<{}>>", class_name)
-                } else {
-                    format!("std::vector<{}>", inner.to_string())
-                }
-            },
-            Type::Dict(key, value) => format!("std::map<{}, {}>", key.to_string(), value.to_string()),
-            Type::Class(name) => format!("std::shared_ptr<{}>", name),
+            Type::List(inner) => format!("std::vector<{}>", inner.to_string()),
+            Type::Dict(key, value) => format!("rl::dict<{}, {}>", key.to_string(), value.to_string()),
+            Type::OrderedDict(key, value) => format!("std::map<{}, {}>", key.to_string(), value.to_string()),
+            Type::MappedFile => "rl::MappedFile".to_string(),
+            Type::FileEntry => "rl::file_entry".to_string(),
+            Type::Writer => "rl::Writer".to_string(),
+            Type::Task(inner) => format!("rl::task<{}>", inner.to_string()),
+            Type::Mutex => "rl::mutex".to_string(),
+            Type::Stopwatch => "rl::stopwatch".to_string(),
+            Type::Atomic(inner) => format!("rl::atomic<{}>", inner.to_string()),
+            Type::Channel(inner) => format!("rl::channel<{}>", inner.to_string()),
+            // Resolves to shared_ptr, unique_ptr or the plain struct depending on
+            // how the class was declared (see stdlib/rl_object.hpp).
+            Type::Class(name) => format!("rl::ref<{}>", name),
         }
     }
 }
 
+impl Type {
+    /// True for types that are cheap to copy and never worth passing by reference.
+    pub fn is_trivial(&self) -> bool {
+        matches!(self, Type::Int | Type::Float | Type::Bool | Type::Void | Type::StrView)
+    }
+
+    /// True for types whose values are worth handing over with `std::move`
+    /// (mutexes and atomics can't be moved at all).
+    pub fn is_movable(&self) -> bool {
+        !self.is_trivial() && !matches!(self, Type::Mutex | Type::Atomic(_))
+    }
+
+    /// True for types whose values can point into a string they don't own.
+    pub fn holds_view(&self) -> bool {
+        match self {
+            Type::StrView => true,
+            Type::List(inner) | Type::Task(inner) | Type::Channel(inner) => inner.holds_view(),
+            Type::Dict(key, value) | Type::OrderedDict(key, value) => key.holds_view() || value.holds_view(),
+            _ => false,
+        }
+    }
+}
+
+/// How instances of a class are owned.
+#[derive(Debug, PartialEq, Clone, Copy, Serialize)]
+pub enum ClassKind {
+    /// `class`: heap-allocated, shared and reference counted (`std::shared_ptr`).
+    Shared,
+    /// `unique class`: heap-allocated with a single owner (`std::unique_ptr`).
+    Unique,
+    /// `struct`: a value type stored inline and copied on assignment.
+    Value,
+}
+
+/// How a function parameter is passed.
+#[derive(Debug, PartialEq, Clone, Copy, Serialize)]
+pub enum ParamMode {
+    /// Read-only. Non-trivial types are passed as `const T&`.
+    Default,
+    /// `mut name: T`. Passed by reference, so writes are visible to the caller.
+    Mut,
+    /// `move name: T`. The caller hands over ownership (`T&&`).
+    Move,
+}
+
+/// A single function parameter.
+#[derive(Debug, PartialEq, Clone, Serialize)]
+pub struct Parameter {
+    pub name: String,
+    pub data_type: Type,
+    pub mode: ParamMode,
+}
+
 /// Represents a literal value in the source code.
 #[derive(Debug, PartialEq, Clone, Serialize)]
 pub enum Literal {
@@ -81,12 +149,23 @@ pub enum Expression {
     /// A function or method call. `callee` is the expression being called.
     Call { callee: Box<Expression>, args: Vec<Expression> },
     Index { list: Box<Expression>, index: Box<Expression> },
+    /// A list index the compiler proved to be in bounds (never produced by the parser).
+    /// Bounds-checked in debug builds only.
+    InRangeIndex { list: Box<Expression>, index: Box<Expression> },
     /// Member access, e.g., `my_object.member`.
     Get { object: Box<Expression>, name: String },
     /// The `this` keyword.
     This,
     /// Heap allocation, e.g., `new MyClass()`.
     New { class_name: String, args: Vec<Expression> },
+    /// `list[T](capacity)`: an empty list with room for `capacity` elements.
+    ListWithCapacity { element_type: Type, capacity: Box<Expression> },
+    /// `spawn f(args)`: runs a call on a new thread and yields its `task[T]`.
+    Spawn(Box<Expression>),
+    /// An f-string, e.g., `f"Hello {name}"`. Parts are string literals and the interpolated expressions, in order.
+    FormatString(Vec<Expression>),
+    /// Ownership transfer, e.g., `move my_list`. Also inserted by the compiler at a `move` parameter's last use.
+    Move(Box<Expression>),
 }
 
 /// Represents a single member of a class (either a variable or a function).
@@ -97,6 +176,21 @@ pub enum ClassMember {
     Constructor(Statement), // Represents the 'init' method
 }
 
+/// Combining operator for `reduce <op> into <var>`.
+#[derive(Debug, PartialEq, Clone, Copy, Serialize)]
+pub enum ReduceOp {
+    Sum,
+    Product,
+    Min,
+    Max,
+}
+
+/// The `parallel` prefix of a `parallel for`, with its optional `reduce <op> into <target>` clause.
+#[derive(Debug, PartialEq, Clone, Serialize)]
+pub struct Parallel {
+    pub reduction: Option<(ReduceOp, String)>,
+}
+
 /// Represents a statement. A statement is a piece of code that performs an action.
 #[derive(Debug, PartialEq, Clone, Serialize)]
 pub enum Statement {
@@ -105,17 +199,34 @@ pub enum Statement {
     Assignment { target: Expression, value: Expression },
     If { condition: Expression, consequence: Vec<Statement>, alternative: Option<Vec<Statement>> },
     While { condition: Expression, body: Vec<Statement> },
-    For { iterator: String, start: Expression, end: Expression, body: Vec<Statement> },
-    Print(Expression),
+    /// `for i in start..end:`. With `parallel` set, the range is split across the thread pool.
+    For { iterator: String, start: Expression, end: Expression, parallel: Option<Parallel>, body: Vec<Statement> },
+    /// `for x in iterable:` over anything with begin()/end(), e.g. `lines(path)`.
+    /// `value` is set for `for k, v in d:`; `is_mutable` for `for mut x in xs:`,
+    /// which binds each element by non-const reference.
+    ForEach { iterator: String, value: Option<String>, is_mutable: bool, iterable: Expression, body: Vec<Statement> },
+    /// `print(a, b, ...)`: prints the values separated by spaces.
+    Print(Vec<Expression>),
     Expression(Expression),
-    FunctionDefinition { is_public: bool, name: String, params: Vec<(String, Type)>, return_type: Type, body: Vec<Statement> },
+    /// `is_bench`: marked `@bench`, so `redline bench` times it.
+    FunctionDefinition { is_public: bool, is_bench: bool, name: String, params: Vec<Parameter>, return_type: Type, body: Vec<Statement> },
     Return(Option<Expression>),
     /// A class definition.
-    Class { is_public: bool, name: String, members: Vec<ClassMember> },
+    Class { is_public: bool, kind: ClassKind, name: String, members: Vec<ClassMember> },
     /// A try-catch block.
     TryCatch { try_block: Vec<Statement>, catch_var: String, catch_block: Vec<Statement> },
+    /// `with arena:` / `with arena(size):`. Objects created inside are bump-allocated and freed together at the end.
+    Arena { initial_size: Option<Expression>, body: Vec<Statement> },
+    /// `lock m:`. Holds the mutex `m` for the duration of the block.
+    Lock { mutex: Expression, body: Vec<Statement> },
     Break,
     Continue,
+    /// Profiling builds only: the next statement comes from `line` of `file`.
+    /// Lowers to a `#line` directive, so debuggers and profilers point at the .rl source.
+    Line { line: usize, file: String },
+    /// Profiling builds only: times the enclosing function body for the report
+    /// printed at exit. `location` is `file.rl:line`.
+    ProfileScope { name: String, location: String },
 }
 
 /// The root of the AST, representing the entire program as a list of statements.
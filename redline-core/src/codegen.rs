@@ -1,4 +1,6 @@
-use crate::ast::{Program, Statement, Expression, Literal, ClassMember, Type};
+use crate::ast::{Program, Statement, Expression, Literal, Type, ClassKind, ClassMember, Parameter, ParamMode, ReduceOp};
+use crate::analysis::{escapes_loop, is_mutated, mark_in_range_loops, members_mutated, move_dead_locals, move_last_use, ByValueArgs};
+use std::collections::{BTreeSet, HashSet};
 use std::fmt;
 use std::path::Path;
 
@@ -19,20 +21,27 @@ impl fmt::Display for CodegenError {
     }
 }
 
-pub fn generate(program: &Program, mode: GenMode, module_name: &str) -> Result<String, CodegenError> {
+/// `program_functions` holds every function and method name defined anywhere in the
+/// program (see `declared_functions`); a call to one of them is never trusted as a builtin.
+pub fn generate(program: &Program, mode: GenMode, module_name: &str, program_functions: &HashSet<String>) -> Result<String, CodegenError> {
     if mode == GenMode::Hpp {
         return generate_hpp(program, module_name);
     }
 
     // --- C++ Generation ---
     let mut cpp_code = String::new();
-    let has_main = program.statements.iter().any(|s| !matches!(s, Statement::FunctionDefinition { .. } | Statement::Import(_) | Statement::Class { .. }));
+    let benches: Vec<&str> = program.statements.iter().filter_map(|s| match s {
+        Statement::FunctionDefinition { is_bench: true, name, .. } => Some(name.as_str()),
+        _ => None,
+    }).collect();
+    // A file of nothing but `@bench` functions still needs a main() to run them.
+    let has_main = !benches.is_empty()
+        || program.statements.iter().any(|s| !matches!(s, Statement::FunctionDefinition { .. } | Statement::Import(_) | Statement::Class { .. }));
 
     // Includes
+    // No <iostream>: the runtime does all its I/O with C stdio, so programs skip
+    // the iostream static initialization and a static link leaves it out.
     let mut includes = format!("// Generated by REDLINE Core for module {}\n", module_name);
-    if has_main {
-        includes.push_str("#include <iostream>\n");
-    }
     includes.push_str("#include <memory>\n"); // For std::shared_ptr
     includes.push_str("#include <map>\n"); // For std::map
     includes.push_str(&format!("#include \"{}.hpp\"\n", module_name));
@@ -42,6 +51,11 @@ pub fn generate(program: &Program, mode: GenMode, module_name: &str) -> Result<S
             includes.push_str(&format!("#include \"{}.hpp\"\n", imported_module_name));
         }
     }
+    // `redline bench` runs any main() through rl::run_benchmarks, even with no @bench
+    // functions, and the module header only includes rl_bench when there are some.
+    if has_main {
+        includes.push_str("#ifdef RL_BENCH\n#include \"stdlib/rl_bench.hpp\"\n#endif\n");
+    }
     cpp_code.push_str(&includes);
 
     // Global variable definition for main module
@@ -51,21 +65,22 @@ pub fn generate(program: &Program, mode: GenMode, module_name: &str) -> Result<S
 
     // Implementations
     cpp_code.push_str("\nnamespace rl {\n\n");
+    let sinks = by_value_args(program);
     for stmt in &program.statements {
         match stmt {
             Statement::FunctionDefinition { .. } => {
-                cpp_code.push_str(&generate_statement(stmt, 0, mode, None)?);
+                cpp_code.push_str(&generate_statement(&prepared_body(stmt, &sinks, program_functions), 0, mode, None)?);
                 cpp_code.push_str("\n");
             }
             Statement::Class { name, members, .. } => {
                 for member in members {
                     match member {
                         ClassMember::Method(method_stmt) => {
-                            cpp_code.push_str(&generate_statement(method_stmt, 0, mode, Some(name))?);
+                            cpp_code.push_str(&generate_statement(&prepared_body(method_stmt, &sinks, program_functions), 0, mode, Some(name))?);
                             cpp_code.push_str("\n");
                         }
                         ClassMember::Constructor(constructor_stmt) => {
-                            cpp_code.push_str(&generate_statement(constructor_stmt, 0, mode, Some(name))?);
+                            cpp_code.push_str(&generate_statement(&prepared_body(constructor_stmt, &sinks, program_functions), 0, mode, Some(name))?);
                             cpp_code.push_str("\n");
                         }
                         _ => {}
@@ -80,11 +95,20 @@ pub fn generate(program: &Program, mode: GenMode, module_name: &str) -> Result<S
     // Main Function
     if has_main {
         cpp_code.push_str("\nint main(int argc, char* argv[]) {\n");
-        cpp_code.push_str("    rl::args.assign(argv, argv + argc);\n");
-        cpp_code.push_str("    std::ios_base::sync_with_stdio(false);\n");
-        cpp_code.push_str("    std::cin.tie(NULL);\n\n");
+        cpp_code.push_str("    rl::args.assign(argv, argv + argc);\n\n");
         cpp_code.push_str("    using namespace rl;\n");
-        let main_body = generate_block(&program.statements, 1, mode)?;
+        // `redline bench` builds with RL_BENCH: run the @bench functions instead of the program.
+        cpp_code.push_str("#ifdef RL_BENCH\n    return rl::run_benchmarks({\n");
+        for name in &benches {
+            cpp_code.push_str(&format!("        rl::bench_case(\"{}\", [] {{ return {}(); }}),\n", name, name));
+        }
+        cpp_code.push_str("    }, rl::args);\n#endif\n");
+        let mut main_statements: Vec<Statement> = program.statements.iter()
+            .filter(|s| !matches!(s, Statement::FunctionDefinition { .. } | Statement::Import(_) | Statement::Class { .. }))
+            .cloned().collect();
+        move_dead_locals(&mut main_statements, &sinks);
+        mark_in_range_loops(&mut main_statements, &mut Vec::new(), &[], program_functions);
+        let main_body = generate_block(&main_statements, 1, mode)?;
         cpp_code.push_str(&main_body);
         cpp_code.push_str("    return 0;\n}\n");
     }
@@ -98,42 +122,55 @@ fn generate_hpp(program: &Program, module_name: &str) -> Result<String, CodegenE
 
     hpp_code.push_str(&format!("#ifndef {}\n#define {}\n\n", guard, guard));
     hpp_code.push_str("#include <memory>\n"); // For std::shared_ptr
-    hpp_code.push_str("#include <map>\n"); // For std::map
-    hpp_code.push_str("#include \"stdlib/rl_io.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_math.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_stdlib.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_file.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_string.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_random.hpp\"\n");
-    hpp_code.push_str("#include \"stdlib/rl_time.hpp\"\n");
-    hpp_code.push_str("#include <string>\n#include <vector>\n\n");
+    hpp_code.push_str("#include <map>\n"); // For std::map (ordered_dict)
+    hpp_code.push_str("#include <utility>\n"); // For std::move
+    let used = used_stdlib_headers(program);
+    for header in STDLIB_HEADERS.iter().filter(|h| used.contains(*h)) {
+        hpp_code.push_str(&format!("#include \"stdlib/{}.hpp\"\n", header));
+    }
+    hpp_code.push_str("#include <string>\n#include <string_view>\n#include <vector>\n\n");
     hpp_code.push_str("namespace rl {\n\n");
 
     for stmt in &program.statements {
-        if let Statement::Class { name, members, .. } = stmt {
+        if let Statement::Class { kind, name, members, .. } = stmt {
+            // Pick the ownership before anything can name rl::ref<Name>, including the class's own members.
+            match kind {
+                ClassKind::Shared => {}
+                ClassKind::Unique => hpp_code.push_str(&format!("class {};\ntemplate<> struct object_traits<{}> : unique_traits<{}> {{}};\n\n", name, name, name)),
+                ClassKind::Value => hpp_code.push_str(&format!("class {};\ntemplate<> struct object_traits<{}> : value_traits<{}> {{}};\n\n", name, name, name)),
+            }
             hpp_code.push_str(&format!("class {} {{\n", name));
             hpp_code.push_str("public:\n");
             for member in members {
                 match member {
                     ClassMember::Variable(Statement::Declaration { name, data_type, initializer, .. }) => {
-                        let initial_value = generate_expression(initializer)?;
+                        let initial_value = generate_initializer(data_type, initializer)?;
                         hpp_code.push_str(&format!("    {} {} = {};\n", data_type.to_string(), name, initial_value));
                     }
-                    ClassMember::Method(Statement::FunctionDefinition { name, params, return_type, .. }) => {
-                        let param_str: Vec<String> = params.iter().map(|(n, t)| format!("{} {}", t.to_string(), n)).collect();
+                    ClassMember::Method(Statement::FunctionDefinition { name, params, return_type, body, .. }) => {
+                        let param_str = generate_params(params, body);
                         hpp_code.push_str(&format!("    {} {}({});\n", return_type.to_string(), name, param_str.join(", ")));
                     }
-                    ClassMember::Constructor(Statement::FunctionDefinition { params, .. }) => {
-                        let param_str: Vec<String> = params.iter().map(|(n, t)| format!("{} {}", t.to_string(), n)).collect();
+                    ClassMember::Constructor(Statement::FunctionDefinition { params, body, .. }) => {
+                        let param_str = generate_params(params, body);
                         hpp_code.push_str(&format!("    {}({});\n", name, param_str.join(", ")));
                     }
                     _ => {}
                 }
             }
+            if *kind == ClassKind::Value {
+                // Structs go into lists and dicts by value, which need a default constructor.
+                let has_default_constructor = members.iter().any(|m| matches!(m, ClassMember::Constructor(Statement::FunctionDefinition { params, .. }) if params.is_empty()));
+                if !has_default_constructor {
+                    hpp_code.push_str(&format!("    {}() = default;\n", name));
+                }
+                hpp_code.push_str(&format!("    {}* operator->() {{ return this; }}\n", name));
+                hpp_code.push_str(&format!("    const {}* operator->() const {{ return this; }}\n", name));
+            }
             hpp_code.push_str("};\n\n");
         }
-        if let Statement::FunctionDefinition { is_public: true, name, params, return_type, .. } = stmt {
-            let param_str: Vec<String> = params.iter().map(|(n, t)| format!("{} {}", t.to_string(), n)).collect();
+        if let Statement::FunctionDefinition { is_public: true, name, params, return_type, body, .. } = stmt {
+            let param_str = generate_params(params, body);
             hpp_code.push_str(&format!("{} {}({});\n", return_type.to_string(), name, param_str.join(", ")));
         }
     }
@@ -143,6 +180,302 @@ fn generate_hpp(program: &Program, module_name: &str) -> Result<String, CodegenE
     Ok(hpp_code)
 }
 
+/// The runtime headers, in include order. The first three hold what nearly
+/// every module needs (object handles, print, len/append/args) and are always
+/// included; the rest only when the module uses something from them, since
+/// they pull in <filesystem>, <thread>, <immintrin.h> and the like.
+const STDLIB_HEADERS: &[&str] = &["rl_object", "rl_io", "rl_stdlib", "rl_math", "rl_dict", "rl_file", "rl_string", "rl_random",
+    "rl_time", "rl_bench", "rl_thread", "rl_parallel", "rl_profile"];
+
+/// The runtime header declaring builtin `name`, for those outside the always-included ones.
+fn stdlib_header(name: &str) -> Option<&'static str> {
+    match name {
+        "sqrt" | "sin" | "cos" | "tan" | "pow" | "exp" | "log" | "log10" | "abs" | "floor" | "ceil" | "round"
+        | "sum" | "dot" | "min" | "max" | "add" | "sub" | "mul" | "scale" | "map_sqrt" => Some("rl_math"),
+        "read_file" | "write_file" | "map_file" | "exists" | "remove" | "list_dir" | "mkdir" | "lines"
+        | "walk" | "walk_parallel" | "file_size" | "open_write" | "open_append" => Some("rl_file"),
+        "split" | "split_view" | "tokenize" | "join" | "contains" => Some("rl_string"),
+        "random_int" | "random_float" | "random_floats" | "random_ints" | "seed" => Some("rl_random"),
+        "time" | "sleep" | "now_ns" | "stopwatch" => Some("rl_time"),
+        "mutex" | "atomic" | "channel" | "cpu_count" => Some("rl_thread"),
+        _ => None,
+    }
+}
+
+fn type_header(data_type: &Type) -> Option<&'static str> {
+    match data_type {
+        Type::Dict(..) | Type::OrderedDict(..) => Some("rl_dict"),
+        Type::MappedFile | Type::FileEntry | Type::Writer => Some("rl_file"),
+        Type::StrView => Some("rl_string"),
+        Type::Stopwatch => Some("rl_time"),
+        Type::Task(_) | Type::Mutex | Type::Atomic(_) | Type::Channel(_) => Some("rl_thread"),
+        _ => None,
+    }
+}
+
+/// Collects the runtime headers `program` needs. Names are matched whether or
+/// not they refer to the builtin: a user function called `max` only costs an
+/// unneeded include.
+fn used_stdlib_headers(program: &Program) -> BTreeSet<&'static str> {
+    let mut used: BTreeSet<&'static str> = STDLIB_HEADERS[..3].iter().copied().collect();
+    program.statements.iter().for_each(|s| statement_headers(s, &mut used));
+    used
+}
+
+fn add_type_headers(data_type: &Type, used: &mut BTreeSet<&'static str>) {
+    used.extend(type_header(data_type));
+    match data_type {
+        Type::List(inner) | Type::Task(inner) | Type::Atomic(inner) | Type::Channel(inner) => add_type_headers(inner, used),
+        Type::Dict(key, value) | Type::OrderedDict(key, value) => {
+            add_type_headers(key, used);
+            add_type_headers(value, used);
+        }
+        _ => {}
+    }
+}
+
+fn statement_headers(stmt: &Statement, used: &mut BTreeSet<&'static str>) {
+    let block = |body: &[Statement], used: &mut BTreeSet<&'static str>| body.iter().for_each(|s| statement_headers(s, used));
+    match stmt {
+        Statement::Declaration { data_type, initializer, .. } => {
+            add_type_headers(data_type, used);
+            expression_headers(initializer, used);
+        }
+        Statement::Assignment { target, value } => {
+            expression_headers(target, used);
+            expression_headers(value, used);
+        }
+        Statement::If { condition, consequence, alternative } => {
+            expression_headers(condition, used);
+            block(consequence, used);
+            if let Some(alt) = alternative {
+                block(alt, used);
+            }
+        }
+        Statement::While { condition, body } => {
+            expression_headers(condition, used);
+            block(body, used);
+        }
+        Statement::For { start, end, parallel, body, .. } => {
+            if parallel.is_some() {
+                used.insert("rl_parallel");
+            }
+            expression_headers(start, used);
+            expression_headers(end, used);
+            block(body, used);
+        }
+        Statement::ForEach { iterable, body, .. } => {
+            expression_headers(iterable, used);
+            block(body, used);
+        }
+        Statement::Print(args) => args.iter().for_each(|a| expression_headers(a, used)),
+        Statement::Expression(expr) | Statement::Return(Some(expr)) => expression_headers(expr, used),
+        Statement::FunctionDefinition { is_bench, params, return_type, body, .. } => {
+            if *is_bench {
+                used.insert("rl_bench");
+            }
+            params.iter().for_each(|p| add_type_headers(&p.data_type, used));
+            add_type_headers(return_type, used);
+            block(body, used);
+        }
+        Statement::Class { members, .. } => members.iter().for_each(|m| match m {
+            ClassMember::Variable(s) | ClassMember::Method(s) | ClassMember::Constructor(s) => statement_headers(s, used),
+        }),
+        Statement::TryCatch { try_block, catch_block, .. } => {
+            block(try_block, used);
+            block(catch_block, used);
+        }
+        Statement::Arena { initial_size, body } => {
+            if let Some(size) = initial_size {
+                expression_headers(size, used);
+            }
+            block(body, used);
+        }
+        Statement::Lock { mutex, body } => {
+            used.insert("rl_thread");
+            expression_headers(mutex, used);
+            block(body, used);
+        }
+        Statement::ProfileScope { .. } => { used.insert("rl_profile"); }
+        Statement::Import(_) | Statement::Return(None) | Statement::Break | Statement::Continue | Statement::Line { .. } => {}
+    }
+}
+
+fn expression_headers(expr: &Expression, used: &mut BTreeSet<&'static str>) {
+    match expr {
+        Expression::Identifier(name) => used.extend(stdlib_header(name)),
+        Expression::Literal(_) | Expression::This => {}
+        Expression::ListLiteral(elements) => elements.iter().for_each(|e| expression_headers(e, used)),
+        Expression::FormatString(parts) => {
+            used.insert("rl_string");
+            parts.iter().for_each(|p| expression_headers(p, used));
+        }
+        Expression::DictLiteral(entries) => entries.iter().for_each(|(k, v)| {
+            expression_headers(k, used);
+            expression_headers(v, used);
+        }),
+        Expression::BinaryOp { left, right, .. } => {
+            expression_headers(left, used);
+            expression_headers(right, used);
+        }
+        Expression::Call { callee, args } => {
+            expression_headers(callee, used);
+            args.iter().for_each(|a| expression_headers(a, used));
+        }
+        Expression::Index { list, index } | Expression::InRangeIndex { list, index } => {
+            expression_headers(list, used);
+            expression_headers(index, used);
+        }
+        Expression::Get { object, .. } => expression_headers(object, used),
+        Expression::New { args, .. } => args.iter().for_each(|a| expression_headers(a, used)),
+        Expression::ListWithCapacity { element_type, capacity } => {
+            add_type_headers(element_type, used);
+            expression_headers(capacity, used);
+        }
+        Expression::Spawn(call) => {
+            used.insert("rl_thread");
+            expression_headers(call, used);
+        }
+        Expression::Move(inner) => expression_headers(inner, used),
+    }
+}
+
+/// Lowers a parameter list. Read-only non-trivial parameters become `const T&`;
+/// ones the body writes to stay by value so the caller's copy is untouched.
+/// Objects whose fields or methods the body uses mutably become `rl::param<T>`,
+/// which is a reference for classes and a copy for structs.
+fn generate_params(params: &[Parameter], body: &[Statement]) -> Vec<String> {
+    params.iter().map(|p| {
+        if let (ParamMode::Default, Type::Class(class_name)) = (p.mode, &p.data_type) {
+            if !is_mutated(body, &p.name) && members_mutated(body, &p.name) {
+                return format!("rl::param<{}> {}", class_name, p.name);
+            }
+        }
+        let type_str = p.data_type.to_string();
+        match p.mode {
+            ParamMode::Mut => format!("{}& {}", type_str, p.name),
+            ParamMode::Move if !p.data_type.is_trivial() => format!("{}&& {}", type_str, p.name),
+            ParamMode::Default if !p.data_type.is_trivial() && !is_mutated(body, &p.name) => format!("const {}& {}", type_str, p.name),
+            _ => format!("{} {}", type_str, p.name),
+        }
+    }).collect()
+}
+
+/// Which arguments this module's functions and constructors take by value,
+/// following the rules of `generate_params`. Overloads only count as taking an
+/// argument by value if all of them do.
+fn by_value_args(program: &Program) -> ByValueArgs {
+    let mut sinks = ByValueArgs::new();
+    let mut record = |key: &str, params: &[Parameter], body: &[Statement]| {
+        let by_value: Vec<bool> = params.iter().map(|p| match p.mode {
+            ParamMode::Move => p.data_type.is_movable(),
+            ParamMode::Default => p.data_type.is_movable() && is_mutated(body, &p.name),
+            ParamMode::Mut => false,
+        }).collect();
+        sinks.entry(key.to_string())
+            .and_modify(|known: &mut Vec<bool>| {
+                known.truncate(by_value.len());
+                known.iter_mut().zip(&by_value).for_each(|(k, v)| *k = *k && *v);
+            })
+            .or_insert(by_value);
+    };
+    for stmt in &program.statements {
+        match stmt {
+            Statement::FunctionDefinition { name, params, body, .. } => record(name, params, body),
+            Statement::Class { name, members, .. } => {
+                for member in members {
+                    if let ClassMember::Constructor(Statement::FunctionDefinition { params, body, .. }) = member {
+                        record(name, params, body);
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    sinks
+}
+
+/// The names this module defines as functions or methods. The driver collects
+/// them from every module of the program for `generate`.
+pub fn declared_functions(program: &Program) -> HashSet<String> {
+    let mut declared = HashSet::new();
+    for stmt in &program.statements {
+        match stmt {
+            Statement::FunctionDefinition { name, .. } => { declared.insert(name.clone()); }
+            Statement::Class { members, .. } => {
+                for member in members {
+                    if let ClassMember::Method(Statement::FunctionDefinition { name, .. }) = member {
+                        declared.insert(name.clone());
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    declared
+}
+
+/// A copy of a function definition whose locals and `move` parameters are moved
+/// at their last use, and whose `xs[i]` accesses in loops over `0..len(xs)` skip
+/// the bounds check where that's provably safe.
+fn prepared_body(definition: &Statement, sinks: &ByValueArgs, declared: &HashSet<String>) -> Statement {
+    let mut definition = definition.clone();
+    if let Statement::FunctionDefinition { params, body, .. } = &mut definition {
+        move_dead_locals(body, sinks);
+        // A parallel loop's chunks each cover part of the same range, so the proof holds for them too.
+        mark_in_range_loops(body, &mut params.iter().map(|p| p.name.clone()).collect(), params, declared);
+        for p in params.iter().filter(|p| p.mode == ParamMode::Move && !p.data_type.is_trivial()) {
+            move_last_use(body, &p.name, sinks);
+        }
+    }
+    definition
+}
+
+/// Lowers a declaration's initializer. `channel(n)` can't infer its element
+/// type in C++, so a constructor call matching the declared type is spelled
+/// with the full type: `val ch: channel[int] = channel(8)` -> `rl::channel<int>(8)`.
+/// List literals of non-trivial elements are built in place; see `generate_list_literal`.
+fn generate_initializer(data_type: &Type, initializer: &Expression) -> Result<String, CodegenError> {
+    if let (Expression::ListLiteral(elements), Type::List(element_type)) = (initializer, data_type) {
+        return generate_list_literal(element_type, elements);
+    }
+    if let Expression::Call { callee, args } = initializer {
+        let constructs_declared_type = match (&**callee, data_type) {
+            (Expression::Identifier(f), Type::Channel(_)) => f == "channel",
+            (Expression::Identifier(f), Type::Atomic(_)) => f == "atomic",
+            _ => false,
+        };
+        if constructs_declared_type {
+            let args_str: Result<Vec<String>, _> = args.iter().map(generate_expression).collect();
+            return Ok(format!("{}({})", data_type.to_string(), args_str?.join(", ")));
+        }
+    }
+    generate_expression(initializer)
+}
+
+/// A list literal whose element type is known. A braced list would build each
+/// string or list once in an initializer_list and then copy it into the vector;
+/// `rl::list_of<T>` reserves once and constructs the elements in place.
+fn generate_list_literal(element_type: &Type, elements: &[Expression]) -> Result<String, CodegenError> {
+    if !builds_in_place(element_type, elements) {
+        return generate_expression(&Expression::ListLiteral(elements.to_vec()));
+    }
+    let mut elems = Vec::new();
+    for element in elements {
+        elems.push(match (element, element_type) {
+            (Expression::ListLiteral(inner), Type::List(inner_type)) if builds_in_place(inner_type, inner) => generate_list_literal(inner_type, inner)?,
+            // A braced list can't be forwarded; name its type.
+            (Expression::ListLiteral(_), _) => format!("{}{}", element_type.to_string(), generate_expression(element)?),
+            _ => generate_expression(element)?,
+        });
+    }
+    Ok(format!("rl::list_of<{}>({})", element_type.to_string(), elems.join(", ")))
+}
+
+fn builds_in_place(element_type: &Type, elements: &[Expression]) -> bool {
+    !element_type.is_trivial() && !elements.is_empty() && !elements.iter().any(|e| matches!(e, Expression::DictLiteral(_)))
+}
+
 fn generate_block(statements: &[Statement], indent_level: usize, mode: GenMode) -> Result<String, CodegenError> {
     let mut block_code = String::new();
     for statement in statements {
@@ -156,17 +489,21 @@ fn generate_block(statements: &[Statement], indent_level: usize, mode: GenMode)
 fn generate_statement(statement: &Statement, indent_level: usize, mode: GenMode, class_scope: Option<&str>) -> Result<String, CodegenError> {
     let indent = "    ".repeat(indent_level);
     match statement {
-        Statement::Declaration { name, data_type, initializer, .. } => {
-            let type_str = match data_type {
-                Type::Class(class_name) => format!("std::shared_ptr<{}>", class_name),
-                Type::Dict(key, value) => format!("std::map<{}, {}>", key.to_string(), value.to_string()),
-                _ => data_type.to_string(),
-            };
-            Ok(format!("{}{} {} = {};\n", indent, type_str, name, generate_expression(initializer)?))
+        Statement::Declaration { is_mutable, name, data_type, initializer, .. } => {
+            // After folding, a `val` whose initializer is a literal is a compile-time constant.
+            // Folding may have replaced every use of it, so it can end up unused.
+            let is_constant = !is_mutable && matches!(data_type, Type::Int | Type::Float | Type::Bool) && matches!(initializer, Expression::Literal(_));
+            let qualifier = if is_constant { "[[maybe_unused]] constexpr " } else { "" };
+            Ok(format!("{}{}{} {} = {};\n", indent, qualifier, data_type.to_string(), name, generate_initializer(data_type, initializer)?))
         },
         Statement::FunctionDefinition { name, params, return_type, body, .. } => {
-            let param_str: Vec<String> = params.iter().map(|(p_name, p_type)| format!("{} {}", p_type.to_string(), p_name)).collect();
+            let param_str = generate_params(params, body);
+            let mut body = body.clone();
             let mut func_def = String::new();
+            // A profiling build's leading `#line` goes above the signature, so the function maps to its `def`.
+            if let Some(Statement::Line { .. }) = body.first() {
+                func_def.push_str(&generate_statement(&body.remove(0), indent_level, mode, class_scope)?);
+            }
             if let Some(class_name) = class_scope {
                 if name == "init" {
                     func_def.push_str(&format!("{}::{}({}) {{\n", class_name, class_name, param_str.join(", ")));
@@ -176,12 +513,21 @@ fn generate_statement(statement: &Statement, indent_level: usize, mode: GenMode,
             } else {
                 func_def.push_str(&format!("{} {}({}) {{\n", return_type.to_string(), name, param_str.join(", ")));
             }
-            func_def.push_str(&generate_block(body, indent_level + 1, mode)?);
+            func_def.push_str(&generate_block(&body, indent_level + 1, mode)?);
             func_def.push_str(&format!("{}}}\n", indent));
             Ok(func_def)
         },
+        // `d[key] = v` has to insert into dicts, which `.at()` can't; rl::set_entry picks per container.
+        // The value is passed in rather than assigned through a reference, so `d[a] = d[b]` has
+        // copied d[b] before inserting `a` can move the entries.
+        Statement::Assignment { target: Expression::Index { list, index }, value } => {
+            Ok(format!("{}rl::set_entry({}, {}, {});\n", indent, generate_expression(list)?, generate_expression(index)?, generate_expression(value)?))
+        }
         Statement::Assignment { target, value } => Ok(format!("{}{} = {};\n", indent, generate_expression(target)?, generate_expression(value)?)),
-        Statement::Print(expr) => Ok(format!("{}print({});\n", indent, generate_expression(expr)?)),
+        Statement::Print(args) => {
+            let args_str: Result<Vec<String>, _> = args.iter().map(generate_expression).collect();
+            Ok(format!("{}print({});\n", indent, args_str?.join(", ")))
+        },
         Statement::Expression(expr) => Ok(format!("{}{};\n", indent, generate_expression(expr)?)),
         Statement::Return(expr) => {
             if let Some(e) = expr {
@@ -209,10 +555,57 @@ fn generate_statement(statement: &Statement, indent_level: usize, mode: GenMode,
             code.push_str(&format!("{}}}\n", indent));
             Ok(code)
         },
-        Statement::For { iterator, start, end, body } => {
+        Statement::For { iterator, start, end, parallel, body } => {
             let start_str = generate_expression(start)?;
             let end_str = generate_expression(end)?;
-            let mut code = format!("{}for (int {} = {}; {} < {}; ++{}) {{\n", indent, iterator, start_str, iterator, end_str, iterator);
+            let Some(parallel) = parallel else {
+                let mut code = format!("{}for (int {} = {}; {} < {}; ++{}) {{\n", indent, iterator, start_str, iterator, end_str, iterator);
+                code.push_str(&generate_block(body, indent_level + 1, mode)?);
+                code.push_str(&format!("{}}}\n", indent));
+                return Ok(code);
+            };
+            if escapes_loop(body) {
+                return Err(CodegenError { message: "'break' and 'return' can't be used inside a 'parallel for'".to_string() });
+            }
+            // Each chunk of the range runs as an ordinary loop, so the body keeps its
+            // serial codegen (and vectorizes the same way). A reduction target is
+            // shadowed by the chunk's private partial, which the runtime combines.
+            let inner_indent = "    ".repeat(indent_level + 1);
+            let mut code = match &parallel.reduction {
+                Some((op, target)) => {
+                    let op_name = match op {
+                        ReduceOp::Sum => "sum",
+                        ReduceOp::Product => "product",
+                        ReduceOp::Min => "min",
+                        ReduceOp::Max => "max",
+                    };
+                    format!("{}{} = rl::parallel_reduce({}, {}, {}, rl::reduce_{}(), [&](int rl_begin, int rl_end, auto {}) {{\n",
+                        indent, target, start_str, end_str, target, op_name, target)
+                }
+                None => format!("{}rl::parallel_for({}, {}, [&](int rl_begin, int rl_end) {{\n", indent, start_str, end_str),
+            };
+            code.push_str(&format!("{}for (int {} = rl_begin; {} < rl_end; ++{}) {{\n", inner_indent, iterator, iterator, iterator));
+            code.push_str(&generate_block(body, indent_level + 2, mode)?);
+            code.push_str(&format!("{}}}\n", inner_indent));
+            if let Some((_, target)) = &parallel.reduction {
+                code.push_str(&format!("{}return {};\n", inner_indent, target));
+            }
+            code.push_str(&format!("{}}});\n", indent));
+            Ok(code)
+        },
+        Statement::ForEach { iterator, value, is_mutable, iterable, body } => {
+            let iterable_str = generate_expression(iterable)?;
+            let mut code = match (value, is_mutable) {
+                (None, false) => format!("{}for (const auto& {} : {}) {{\n", indent, iterator, iterable_str),
+                (None, true) => format!("{}for (auto& {} : {}) {{\n", indent, iterator, iterable_str),
+                (Some(value), false) => format!("{}for (const auto& [{}, {}] : {}) {{\n", indent, iterator, value, iterable_str),
+                // Only the value is writable: changing a key in place would corrupt the dict.
+                (Some(value), true) => {
+                    let inner_indent = "    ".repeat(indent_level + 1);
+                    format!("{}for (auto& rl_entry : {}) {{\n{}const auto& {} = rl_entry.first;\n{}auto& {} = rl_entry.second;\n",
+                        indent, iterable_str, inner_indent, iterator, inner_indent, value)
+                }
+            };
             code.push_str(&generate_block(body, indent_level + 1, mode)?);
             code.push_str(&format!("{}}}\n", indent));
             Ok(code)
@@ -225,39 +618,117 @@ fn generate_statement(statement: &Statement, indent_level: usize, mode: GenMode,
             code.push_str(&format!("{}}}\n", indent));
             Ok(code)
         },
+        Statement::Arena { initial_size, body } => {
+            let mut code = format!("{}{{\n", indent);
+            let inner_indent = "    ".repeat(indent_level + 1);
+            match initial_size {
+                Some(size) => code.push_str(&format!("{}rl::Arena rl_arena_scope({});\n", inner_indent, generate_expression(size)?)),
+                None => code.push_str(&format!("{}rl::Arena rl_arena_scope;\n", inner_indent)),
+            }
+            code.push_str(&generate_block(body, indent_level + 1, mode)?);
+            code.push_str(&format!("{}}}\n", indent));
+            Ok(code)
+        },
+        Statement::Lock { mutex, body } => {
+            let mut code = format!("{}{{\n", indent);
+            code.push_str(&format!("{}    rl::lock_scope rl_lock_scope({});\n", indent, generate_expression(mutex)?));
+            code.push_str(&generate_block(body, indent_level + 1, mode)?);
+            code.push_str(&format!("{}}}\n", indent));
+            Ok(code)
+        },
         Statement::Break => Ok(format!("{}break;\n", indent)),
         Statement::Continue => Ok(format!("{}continue;\n", indent)),
+        Statement::Line { line, file } => Ok(format!("#line {} \"{}\"\n", line, escape_string(file))),
+        // One line, so it doesn't shift the `#line` numbering of the statements after it. The
+        // depth counter keeps a recursive function's time from being counted once per level.
+        Statement::ProfileScope { name, location } => Ok(format!(
+            "{}static thread_local int rl_profile_depth = 0; static rl::profile_site rl_profile_site(\"{}\", \"{}\"); rl::profile_timer rl_profile_timer(rl_profile_site, rl_profile_depth);\n",
+            indent, escape_string(name), escape_string(location))),
         _ => Ok("".to_string())
     }
 }
 
+/// Escapes a string so it can be emitted as a C++ string literal.
+fn escape_string(s: &str) -> String {
+    let mut escaped = String::with_capacity(s.len());
+    for c in s.chars() {
+        match c {
+            '"' => escaped.push_str("\\\""),
+            '\\' => escaped.push_str("\\\\"),
+            '\n' => escaped.push_str("\\n"),
+            '\t' => escaped.push_str("\\t"),
+            '\r' => escaped.push_str("\\r"),
+            _ => escaped.push(c),
+        }
+    }
+    escaped
+}
+
 fn generate_expression(expr: &Expression) -> Result<String, CodegenError> {
     match expr {
         Expression::New { class_name, args } => {
             let args_str: Result<Vec<String>, _> = args.iter().map(generate_expression).collect();
-            Ok(format!("std::make_shared<{}>({})", class_name, args_str?.join(", ")))
+            Ok(format!("rl::make<{}>({})", class_name, args_str?.join(", ")))
         },
         Expression::This => Ok("this".to_string()),
+        Expression::Move(inner) => Ok(format!("std::move({})", generate_expression(inner)?)),
+        Expression::ListWithCapacity { element_type, capacity } => {
+            Ok(format!("rl::with_capacity<{}>({})", element_type.to_string(), generate_expression(capacity)?))
+        }
+        // Arguments are captured by copy; threads, locks, atomics and channels are handles, so copies share state.
+        Expression::Spawn(call) => Ok(format!("rl::spawn([=]() {{ return {}; }})", generate_expression(call)?)),
+        // `.` always lowers to `->`: classes are rl::ref handles, and value types (generated
+        // structs, rl::stopwatch, rl::file_entry) define an `operator->` that returns `this`.
         Expression::Get { object, name } => {
             Ok(format!("{}->{}", generate_expression(object)?, name))
         }
         Expression::Identifier(name) => {
             match name.as_str() {
                 "to_string" => Ok("rl::to_string".to_string()),
-                "to_int" => Ok("std::stoi".to_string()),
-                "to_float" => Ok("std::stod".to_string()),
+                "to_int" => Ok("rl::to_int".to_string()),
+                "to_float" => Ok("rl::to_float".to_string()),
+                "try_to_int" => Ok("rl::try_to_int".to_string()),
+                "try_to_float" => Ok("rl::try_to_float".to_string()),
                 "read_file" => Ok("rl::read_file".to_string()),
                 "write_file" => Ok("rl::write_file".to_string()),
+                "map_file" => Ok("rl::map_file".to_string()),
+                // `lines` and `walk` stay unqualified so they don't capture user names;
+                // `using namespace rl` finds rl::lines and rl::walk otherwise.
+                "flush" => Ok("rl::flush".to_string()),
+                "print_unbuffered" => Ok("rl::print_unbuffered".to_string()),
+                "set_line_buffered" => Ok("rl::set_line_buffered".to_string()),
                 "split" => Ok("rl::split".to_string()),
+                "split_view" => Ok("rl::split_view".to_string()),
+                "tokenize" => Ok("rl::tokenize".to_string()),
                 "join" => Ok("rl::join".to_string()),
                 "contains" => Ok("rl::contains".to_string()),
+                "unsafe_get" => Ok("rl::unsafe_get".to_string()),
+                "dot" => Ok("rl::dot".to_string()),
+                "map_sqrt" => Ok("rl::map_sqrt".to_string()),
+                "reserve" => Ok("rl::reserve".to_string()),
+                "resize" => Ok("rl::resize".to_string()),
+                "shrink_to_fit" => Ok("rl::shrink_to_fit".to_string()),
+                // The other bulk math builtins (sum, min, max, scale, add, sub, mul) are
+                // common variable and function names, so they stay unqualified like `lines`.
+                "mutex" => Ok("rl::mutex".to_string()),
+                "stopwatch" => Ok("rl::stopwatch".to_string()),
+                "now_ns" => Ok("rl::now_ns".to_string()),
+                "atomic" => Ok("rl::atomic".to_string()),
+                "cpu_count" => Ok("rl::cpu_count".to_string()),
                 "args" => Ok("rl::args".to_string()),
                 "exists" => Ok("rl::exists".to_string()),
                 "remove" => Ok("rl::remove".to_string()),
                 "list_dir" => Ok("rl::list_dir".to_string()),
+                "walk_parallel" => Ok("rl::walk_parallel".to_string()),
+                "file_size" => Ok("rl::file_size".to_string()),
+                "open_write" => Ok("rl::open_write".to_string()),
+                "open_append" => Ok("rl::open_append".to_string()),
                 "mkdir" => Ok("rl::mkdir".to_string()),
                 "random_int" => Ok("rl::random_int".to_string()),
                 "random_float" => Ok("rl::random_float".to_string()),
+                "random_floats" => Ok("rl::random_floats".to_string()),
+                "random_ints" => Ok("rl::random_ints".to_string()),
+                // `seed` is left unqualified too: it's a common variable name.
                 "time" => Ok("rl::time".to_string()),
                 "sleep" => Ok("rl::sleep".to_string()),
                 _ => Ok(name.clone()),
@@ -269,11 +740,17 @@ fn generate_expression(expr: &Expression) -> Result<String, CodegenError> {
             Ok(format!("{}({})", callee_str, args_str?.join(", ")))
         },
         Expression::Literal(Literal::Int(n)) => Ok(n.to_string()),
-        Expression::Literal(Literal::Float(n)) => Ok(n.to_string()),
-        Expression::Literal(Literal::String(s)) => Ok(format!("\"{}\"", s)),
+        // `{:?}` keeps the decimal point (2.0, not 2), so C++ sees a double.
+        Expression::Literal(Literal::Float(n)) => Ok(format!("{:?}", n)),
+        Expression::Literal(Literal::String(s)) => Ok(format!("\"{}\"", escape_string(s))),
         Expression::Literal(Literal::Bool(b)) => Ok(if *b { "true".to_string() } else { "false".to_string() }),
         Expression::Index { list, index } => Ok(format!("{}.at({})", generate_expression(list)?, generate_expression(index)?)),
+        Expression::InRangeIndex { list, index } => Ok(format!("rl::at_in_range({}, {})", generate_expression(list)?, generate_expression(index)?)),
         Expression::BinaryOp { op, left, right } => Ok(format!("({} {} {})", generate_expression(left)?, op.to_string(), generate_expression(right)?)),
+        Expression::FormatString(parts) => {
+            let parts_str: Result<Vec<String>, _> = parts.iter().map(generate_expression).collect();
+            Ok(format!("rl::format({})", parts_str?.join(", ")))
+        },
         Expression::ListLiteral(elements) => {
             let elems: Result<Vec<String>, _> = elements.iter().map(generate_expression).collect();
             Ok(format!("{{ {} }}", elems?.join(", ")))
@@ -0,0 +1,334 @@
+//! Constant folding, run between parsing and codegen. Arithmetic and
+//! comparisons on literals are evaluated the way the generated C++ would
+//! evaluate them, scalar `val`s with constant initializers are substituted into
+//! the expressions that read them, and an `if` or `while` whose condition
+//! folds to a constant loses the branch that can never run.
+use crate::analysis::is_mutated;
+use crate::ast::{Program, Statement, Expression, Literal, BinaryOperator, Type, ClassMember};
+use std::collections::{HashMap, HashSet};
+
+/// Folds `program` in place.
+pub fn fold_program(program: &mut Program) {
+    let user_names: HashSet<String> = program.statements.iter().filter_map(|s| match s {
+        Statement::FunctionDefinition { name, .. } | Statement::Class { name, .. } => Some(name.clone()),
+        _ => None,
+    }).collect();
+    let mut folder = Folder { scopes: Vec::new(), user_names };
+    folder.block(&mut program.statements);
+}
+
+struct Folder {
+    /// Every variable in scope, innermost last. `Some` for a `val` known at compile time.
+    scopes: Vec<HashMap<String, Option<Literal>>>,
+    /// Top-level functions and classes, which hide builtins of the same name.
+    user_names: HashSet<String>,
+}
+
+impl Folder {
+    fn lookup(&self, name: &str) -> Option<&Option<Literal>> {
+        self.scopes.iter().rev().find_map(|scope| scope.get(name))
+    }
+
+    fn declare(&mut self, name: &str, value: Option<Literal>) {
+        if let Some(scope) = self.scopes.last_mut() {
+            scope.insert(name.to_string(), value);
+        }
+    }
+
+    /// True if `name` refers to the builtin: nothing in scope or at the top level shadows it.
+    fn is_builtin(&self, name: &str) -> bool {
+        self.lookup(name).is_none() && !self.user_names.contains(name)
+    }
+
+    /// Folds a block in its own scope, splicing in the live branch of any `if` that folded.
+    fn block(&mut self, block: &mut Vec<Statement>) {
+        self.scopes.push(HashMap::new());
+        // A `val` something writes to anyway is just a variable; decide before folding rewrites the rest.
+        let written: Vec<bool> = (0..block.len()).map(|i| match &block[i] {
+            Statement::Declaration { is_mutable: false, name, .. } => is_mutated(&block[i + 1..], name),
+            _ => false,
+        }).collect();
+
+        let mut folded = Vec::with_capacity(block.len());
+        for (mut stmt, written) in std::mem::take(block).into_iter().zip(written) {
+            if let Statement::Declaration { is_mutable, .. } = &mut stmt {
+                *is_mutable |= written;
+            }
+            self.statement(&mut stmt);
+            match stmt {
+                Statement::If { condition: Expression::Literal(Literal::Bool(taken)), consequence, alternative } => {
+                    let live = if taken { Some(consequence) } else { alternative };
+                    match live {
+                        Some(live) if live.iter().any(|s| matches!(s, Statement::Declaration { .. })) => {
+                            // Keep the branch's own scope for its declarations.
+                            folded.push(Statement::If { condition: Expression::Literal(Literal::Bool(true)), consequence: live, alternative: None });
+                        }
+                        Some(live) => folded.extend(live),
+                        None => {}
+                    }
+                }
+                Statement::While { condition: Expression::Literal(Literal::Bool(false)), .. } => {}
+                stmt => folded.push(stmt),
+            }
+        }
+        *block = folded;
+        self.scopes.pop();
+    }
+
+    /// Folds a function body in a fresh scope: it can't see the variables around its definition.
+    fn function_body(&mut self, names: impl Iterator<Item = String>, body: &mut Vec<Statement>) {
+        let outer = std::mem::take(&mut self.scopes);
+        self.scopes.push(names.map(|n| (n, None)).collect());
+        self.block(body);
+        self.scopes = outer;
+    }
+
+    fn statement(&mut self, stmt: &mut Statement) {
+        match stmt {
+            Statement::Declaration { is_mutable, name, data_type, initializer, .. } => {
+                self.expression(initializer);
+                let value = match (&*initializer, &*data_type) {
+                    (Expression::Literal(Literal::Int(n)), Type::Int) if fits_int(*n) => Some(Literal::Int(*n)),
+                    (Expression::Literal(Literal::Int(n)), Type::Float) if fits_int(*n) => Some(Literal::Float(*n as f64)),
+                    (Expression::Literal(Literal::Float(x)), Type::Float) => Some(Literal::Float(*x)),
+                    (Expression::Literal(Literal::Bool(b)), Type::Bool) => Some(Literal::Bool(*b)),
+                    _ => None,
+                };
+                if let Some(Literal::Float(x)) = &value {
+                    *initializer = Expression::Literal(Literal::Float(*x));
+                }
+                let name = name.clone();
+                self.declare(&name, if *is_mutable { None } else { value });
+            }
+            Statement::Assignment { target, value } => {
+                self.expression(target);
+                self.expression(value);
+            }
+            Statement::If { condition, consequence, alternative } => {
+                self.expression(condition);
+                self.block(consequence);
+                if let Some(alt) = alternative {
+                    self.block(alt);
+                }
+            }
+            Statement::While { condition, body } => {
+                self.expression(condition);
+                self.block(body);
+            }
+            Statement::For { iterator, start, end, body, .. } => {
+                self.expression(start);
+                self.expression(end);
+                self.scopes.push(HashMap::from([(iterator.clone(), None)]));
+                self.block(body);
+                self.scopes.pop();
+            }
+            Statement::ForEach { iterator, value, iterable, body, .. } => {
+                self.expression(iterable);
+                let mut scope = HashMap::from([(iterator.clone(), None)]);
+                if let Some(value) = value {
+                    scope.insert(value.clone(), None);
+                }
+                self.scopes.push(scope);
+                self.block(body);
+                self.scopes.pop();
+            }
+            Statement::Print(args) => args.iter_mut().for_each(|a| self.expression(a)),
+            Statement::Expression(expr) | Statement::Return(Some(expr)) => self.expression(expr),
+            Statement::FunctionDefinition { params, body, .. } => {
+                let names: Vec<String> = params.iter().map(|p| p.name.clone()).collect();
+                self.function_body(names.into_iter(), body);
+            }
+            Statement::Class { members, .. } => {
+                // Methods can name fields without `this.`, so the fields shadow like locals.
+                let fields: Vec<String> = members.iter().filter_map(|m| match m {
+                    ClassMember::Variable(Statement::Declaration { name, .. }) => Some(name.clone()),
+                    _ => None,
+                }).collect();
+                for member in members.iter_mut() {
+                    match member {
+                        ClassMember::Variable(Statement::Declaration { initializer, .. }) => {
+                            let outer = std::mem::take(&mut self.scopes);
+                            self.expression(initializer);
+                            self.scopes = outer;
+                        }
+                        ClassMember::Method(Statement::FunctionDefinition { params, body, .. })
+                        | ClassMember::Constructor(Statement::FunctionDefinition { params, body, .. }) => {
+                            let names: Vec<String> = fields.iter().cloned().chain(params.iter().map(|p| p.name.clone())).collect();
+                            self.function_body(names.into_iter(), body);
+                        }
+                        _ => {}
+                    }
+                }
+            }
+            Statement::TryCatch { try_block, catch_var, catch_block } => {
+                self.block(try_block);
+                self.scopes.push(HashMap::from([(catch_var.clone(), None)]));
+                self.block(catch_block);
+                self.scopes.pop();
+            }
+            Statement::Arena { initial_size, body } => {
+                if let Some(size) = initial_size {
+                    self.expression(size);
+                }
+                self.block(body);
+            }
+            Statement::Lock { mutex, body } => {
+                self.expression(mutex);
+                self.block(body);
+            }
+            Statement::Import(_) | Statement::Return(None) | Statement::Break | Statement::Continue
+            | Statement::Line { .. } | Statement::ProfileScope { .. } => {}
+        }
+    }
+
+    fn expression(&mut self, expr: &mut Expression) {
+        match expr {
+            Expression::Identifier(name) => {
+                let value = match self.lookup(name) {
+                    Some(known) => known.clone(),
+                    None if self.user_names.contains(name.as_str()) => None,
+                    None => match name.as_str() {
+                        "PI" => Some(Literal::Float(std::f64::consts::PI)),
+                        "E" => Some(Literal::Float(std::f64::consts::E)),
+                        _ => None,
+                    },
+                };
+                if let Some(value) = value {
+                    *expr = Expression::Literal(value);
+                }
+            }
+            Expression::BinaryOp { op, left, right } => {
+                self.expression(left);
+                self.expression(right);
+                if let (Expression::Literal(l), Expression::Literal(r)) = (&**left, &**right) {
+                    if let Some(value) = fold_binary(op, l, r) {
+                        *expr = Expression::Literal(value);
+                    }
+                }
+            }
+            Expression::Call { callee, args } => {
+                // The callee is a function name, never a constant.
+                if !matches!(&**callee, Expression::Identifier(_)) {
+                    self.expression(callee);
+                }
+                args.iter_mut().for_each(|a| self.expression(a));
+                if let Expression::Identifier(f) = &**callee {
+                    if self.is_builtin(f) {
+                        if let Some(value) = fold_builtin(f, args) {
+                            *expr = Expression::Literal(value);
+                        }
+                    }
+                }
+            }
+            Expression::ListLiteral(elements) | Expression::FormatString(elements) | Expression::New { args: elements, .. } => {
+                elements.iter_mut().for_each(|e| self.expression(e));
+            }
+            Expression::DictLiteral(entries) => entries.iter_mut().for_each(|(k, v)| {
+                self.expression(k);
+                self.expression(v);
+            }),
+            Expression::Index { list, index } | Expression::InRangeIndex { list, index } => {
+                self.expression(list);
+                self.expression(index);
+            }
+            Expression::Get { object, .. } => self.expression(object),
+            Expression::ListWithCapacity { capacity, .. } => self.expression(capacity),
+            Expression::Spawn(inner) | Expression::Move(inner) => self.expression(inner),
+            Expression::Literal(_) | Expression::This => {}
+        }
+    }
+}
+
+/// REDLINE's `int` is a C++ `int`. Results outside it are left for the C++
+/// compiler, as are values whose literal would have a different type
+/// (`-2147483648` is a `long` in C++).
+fn fits_int(n: i64) -> bool {
+    n > i32::MIN as i64 && n <= i32::MAX as i64
+}
+
+fn as_float(literal: &Literal) -> Option<f64> {
+    match literal {
+        Literal::Int(n) => Some(*n as f64),
+        Literal::Float(x) => Some(*x),
+        _ => None,
+    }
+}
+
+fn fold_binary(op: &BinaryOperator, left: &Literal, right: &Literal) -> Option<Literal> {
+    use BinaryOperator::*;
+    match (left, right) {
+        (Literal::Int(a), Literal::Int(b)) if fits_int(*a) && fits_int(*b) => {
+            let value = match op {
+                Add => a + b,
+                Subtract => a - b,
+                Multiply => a * b,
+                // Truncates toward zero, like C++.
+                Divide if *b != 0 => a / b,
+                Divide => return None,
+                _ => return compare(op, a, b),
+            };
+            if fits_int(value) { Some(Literal::Int(value)) } else { None }
+        }
+        (Literal::Int(_) | Literal::Float(_), Literal::Int(_) | Literal::Float(_)) => {
+            if matches!(left, Literal::Int(n) if !fits_int(*n)) || matches!(right, Literal::Int(n) if !fits_int(*n)) {
+                return None;
+            }
+            // An int operand is converted to double, as in C++.
+            let (a, b) = (as_float(left)?, as_float(right)?);
+            let value = match op {
+                Add => a + b,
+                Subtract => a - b,
+                Multiply => a * b,
+                Divide if b != 0.0 => a / b,
+                Divide => return None,
+                _ => return compare(op, &a, &b),
+            };
+            if value.is_finite() { Some(Literal::Float(value)) } else { None }
+        }
+        (Literal::Bool(a), Literal::Bool(b)) => match op {
+            Equal => Some(Literal::Bool(a == b)),
+            NotEqual => Some(Literal::Bool(a != b)),
+            _ => None,
+        },
+        (Literal::String(a), Literal::String(b)) => match op {
+            Add => Some(Literal::String(format!("{}{}", a, b))),
+            Equal => Some(Literal::Bool(a == b)),
+            NotEqual => Some(Literal::Bool(a != b)),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+fn compare<T: PartialOrd>(op: &BinaryOperator, a: &T, b: &T) -> Option<Literal> {
+    use BinaryOperator::*;
+    Some(Literal::Bool(match op {
+        Equal => a == b,
+        NotEqual => a != b,
+        GreaterThan => a > b,
+        LessThan => a < b,
+        GreaterThanEqual => a >= b,
+        LessThanEqual => a <= b,
+        _ => return None,
+    }))
+}
+
+/// Builtins whose result on literal arguments is exact, so evaluating them
+/// here gives the same bits the runtime would.
+fn fold_builtin(name: &str, args: &[Expression]) -> Option<Literal> {
+    let literals: Vec<&Literal> = args.iter().map(|a| match a {
+        Expression::Literal(l) => Some(l),
+        _ => None,
+    }).collect::<Option<_>>()?;
+    match (name, literals.as_slice()) {
+        // The runtime measures a C string, which would stop at a NUL.
+        ("len", [Literal::String(s)]) if !s.contains('\0') => i64::try_from(s.len()).ok().filter(|n| fits_int(*n)).map(Literal::Int),
+        ("sqrt", [Literal::Float(x)]) if *x >= 0.0 => Some(Literal::Float(x.sqrt())),
+        ("abs", [Literal::Float(x)]) => Some(Literal::Float(x.abs())),
+        ("floor", [Literal::Float(x)]) => Some(Literal::Float(x.floor())),
+        ("ceil", [Literal::Float(x)]) => Some(Literal::Float(x.ceil())),
+        ("min", [Literal::Float(a), Literal::Float(b)]) => Some(Literal::Float(if a < b { *a } else { *b })),
+        ("max", [Literal::Float(a), Literal::Float(b)]) => Some(Literal::Float(if a > b { *a } else { *b })),
+        _ => None,
+    }
+}
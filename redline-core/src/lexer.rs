@@ -9,7 +9,7 @@ pub enum TokenType {
     Ident(String), Int(i64), Float(f64), Str(String), FString(String), Type(String),
 
     // Operators and Punctuation
-    Op(String), Arrow, Colon, Assign, LParen, RParen, LBracket, RBracket, LBrace, RBrace, Comma, Newline, Range, Dot,
+    Op(String), Arrow, Colon, Assign, LParen, RParen, LBracket, RBracket, LBrace, RBrace, Comma, Newline, Range, Dot, At,
 
     // Indentation
     Indent, Dedent,
@@ -167,6 +167,7 @@ impl Lexer {
                         self.advance();
                     }
                 },
+                '@' => { tokens.push(Token::new(TokenType::At, self.line, start_col)); self.advance(); },
                 '#' => { while self.pos < self.input.len() && self.input[self.pos] != '\n' { self.advance(); } },
                 '"' => {
                     self.advance();
@@ -248,7 +249,9 @@ impl Lexer {
                         "import" => TokenType::Import, "class" => TokenType::Class, "this" => TokenType::This,
                         "try" => TokenType::Try, "catch" => TokenType::Catch, "new" => TokenType::New,
                         "break" => TokenType::Break, "continue" => TokenType::Continue,
-                        "int" | "float" | "string" | "bool" | "list" | "void" | "dict" => TokenType::Type(ident),
+                        // `mut`, `move`, `struct`, `unique`, `with`, `lock` and `spawn` are only
+                        // keywords where the parser expects them, so they stay usable as names.
+                        "int" | "float" | "string" | "str_view" | "bool" | "list" | "void" | "dict" | "ordered_dict" | "mapped_file" => TokenType::Type(ident),
                         _ => TokenType::Ident(ident),
                     };
                     tokens.push(Token::new(token_type, self.line, start_col));
@@ -1,16 +1,22 @@
+use std::collections::{HashMap, HashSet};
 use std::env;
 use std::fs;
 use std::process;
-use std::path::Path;
+use std::path::{Path, PathBuf};
 
 mod codegen;
 mod lexer;
 mod parser;
 mod ast;
+mod analysis;
+mod fold;
+mod profile;
 
 use lexer::Lexer;
 use parser::Parser;
-use codegen::{generate, GenMode};
+use codegen::{declared_functions, generate, GenMode};
+use ast::{Program, Statement};
+use serde::Serialize;
 
 fn report_error(file_path: &str, input: &str, message: &str, line: usize, column: usize) {
     eprintln!("\nError: {}", message);
@@ -28,13 +34,219 @@ fn report_error(file_path: &str, input: &str, message: &str, line: usize, column
     }
 }
 
+/// What a `--profile` build adds to the generated code.
+#[derive(Clone, Copy, PartialEq)]
+enum Profiling {
+    Off,
+    /// `--profile`: `#line` directives pointing back at the .rl sources.
+    Lines,
+    /// `--profile=timers`: line directives plus a scope timer in every function.
+    Timers,
+}
+
+impl Profiling {
+    fn from_args(args: &[String]) -> Self {
+        if args.iter().any(|arg| arg == "--profile=timers") {
+            Profiling::Timers
+        } else if args.iter().any(|arg| arg == "--profile") {
+            Profiling::Lines
+        } else {
+            Profiling::Off
+        }
+    }
+}
+
+/// Lexes and parses a single file, reporting any error against its source.
+fn parse_file(file_path: &str, profiling: Profiling) -> Result<Program, ()> {
+    let content = match fs::read_to_string(file_path) {
+        Ok(c) => c,
+        Err(e) => {
+            eprintln!("Error reading file [{}]: {}", file_path, e);
+            return Err(());
+        }
+    };
+
+    let tokens = match Lexer::new(content.clone()).tokenize() {
+        Ok(t) => t,
+        Err(e) => {
+            report_error(file_path, &content, &e.message, e.line, e.column);
+            return Err(());
+        }
+    };
+
+    let mut parser = Parser::new(&tokens);
+    if profiling != Profiling::Off {
+        parser = parser.with_line_markers(file_path);
+    }
+    match parser.parse() {
+        Ok(mut p) => {
+            if profiling == Profiling::Timers {
+                profile::insert_scope_timers(&mut p);
+            }
+            Ok(p)
+        }
+        Err(e) => {
+            report_error(file_path, &content, &e.message, e.line, e.column);
+            Err(())
+        }
+    }
+}
+
+/// One entry of the dependency manifest written by `--gen-all`.
+#[derive(Serialize)]
+struct ModuleManifest {
+    name: String,
+    source: String,
+    /// Import paths exactly as written in the source.
+    imports: Vec<String>,
+    /// Resolved source paths of the imported modules.
+    dependencies: Vec<String>,
+    hpp: String,
+    cpp: String,
+}
+
+#[derive(Serialize)]
+struct DepsManifest {
+    entry: String,
+    /// Modules in dependency order: every module appears after the modules it imports.
+    modules: Vec<ModuleManifest>,
+}
+
+/// Strips the `\\?\` prefix `canonicalize` adds on Windows so paths stay readable.
+fn display_path(path: &Path) -> String {
+    let s = path.to_string_lossy().to_string();
+    match s.strip_prefix(r"\\?\") {
+        Some(stripped) => stripped.to_string(),
+        None => s,
+    }
+}
+
+/// Writes `contents` to `path` unless it already holds exactly that, so unchanged outputs keep their mtime.
+fn write_if_changed(path: &Path, contents: &str) -> Result<(), String> {
+    if let Ok(existing) = fs::read_to_string(path) {
+        if existing == contents {
+            return Ok(());
+        }
+    }
+    fs::write(path, contents).map_err(|e| format!("Error writing [{}]: {}", display_path(path), e))
+}
+
+/// A parsed module, with its imports resolved, waiting to be generated.
+struct LoadedModule {
+    name: String,
+    source: String,
+    program: Program,
+    /// Import paths exactly as written in the source.
+    imports: Vec<String>,
+    /// Resolved source paths of the imported modules.
+    dependencies: Vec<String>,
+}
+
+/// Parses a module and, depth-first, everything it imports. Each file is parsed exactly once,
+/// and `modules` ends up in dependency order.
+fn load_module(source: &Path, profiling: Profiling, done: &mut HashMap<PathBuf, String>, modules: &mut Vec<LoadedModule>) -> Result<(), String> {
+    if done.contains_key(source) {
+        return Ok(());
+    }
+    let module_name = source.file_stem().unwrap().to_str().unwrap().to_string();
+    if let Some((other, _)) = done.iter().find(|(_, name)| **name == module_name) {
+        return Err(format!("Two modules are named '{}': {} and {}", module_name, display_path(other), display_path(source)));
+    }
+    // Mark before recursing so circular imports terminate.
+    done.insert(source.to_path_buf(), module_name.clone());
+
+    let source_str = display_path(source);
+    let mut program = parse_file(&source_str, profiling).map_err(|_| format!("Failed to parse {}", source_str))?;
+    fold::fold_program(&mut program);
+
+    let mut imports = Vec::new();
+    let mut dependencies = Vec::new();
+    for stmt in &program.statements {
+        if let Statement::Import(path) = stmt {
+            let import_path = source.parent().unwrap().join(path);
+            let resolved = fs::canonicalize(&import_path)
+                .map_err(|e| format!("Cannot import \"{}\" from {}: {}", path, source_str, e))?;
+            load_module(&resolved, profiling, done, modules)?;
+            imports.push(path.clone());
+            dependencies.push(display_path(&resolved));
+        }
+    }
+
+    modules.push(LoadedModule { name: module_name, source: source_str, program, imports, dependencies });
+    Ok(())
+}
+
+/// Parses the program rooted at `entry`. Returns its modules in dependency order, the
+/// entry last, and every function or method name any of them defines: a unity build
+/// puts them all in one translation unit, so any of them may shadow a builtin.
+fn load_program(entry: &Path, profiling: Profiling) -> Result<(Vec<LoadedModule>, HashSet<String>), String> {
+    let mut modules = Vec::new();
+    load_module(entry, profiling, &mut HashMap::new(), &mut modules)?;
+    let functions = modules.iter().flat_map(|module| declared_functions(&module.program)).collect();
+    Ok((modules, functions))
+}
+
+/// `--gen-all <entry.rl> --out <dir>`: generates every module reachable from the
+/// entry point in one process and writes `<dir>/deps.json` describing the import graph.
+fn gen_all(entry: &str, out_dir: &str, profiling: Profiling) -> Result<(), String> {
+    let out_dir = Path::new(out_dir);
+    fs::create_dir_all(out_dir).map_err(|e| format!("Error creating [{}]: {}", out_dir.display(), e))?;
+    let out_dir = fs::canonicalize(out_dir).map_err(|e| format!("Error resolving [{}]: {}", out_dir.display(), e))?;
+    let entry_path = fs::canonicalize(entry).map_err(|e| format!("Error reading file [{}]: {}", entry, e))?;
+
+    let (loaded, functions) = load_program(&entry_path, profiling)?;
+    let mut modules = Vec::new();
+    for module in loaded {
+        let hpp_path = out_dir.join(format!("{}.hpp", module.name));
+        let cpp_path = out_dir.join(format!("{}.cpp", module.name));
+        let hpp = generate(&module.program, GenMode::Hpp, &module.name, &functions).map_err(|e| format!("{} ({})", e, module.source))?;
+        let cpp = generate(&module.program, GenMode::Cpp, &module.name, &functions).map_err(|e| format!("{} ({})", e, module.source))?;
+        write_if_changed(&hpp_path, &hpp)?;
+        write_if_changed(&cpp_path, &cpp)?;
+
+        modules.push(ModuleManifest {
+            name: module.name,
+            source: module.source,
+            imports: module.imports,
+            dependencies: module.dependencies,
+            hpp: display_path(&hpp_path),
+            cpp: display_path(&cpp_path),
+        });
+    }
+
+    let manifest = DepsManifest { entry: display_path(&entry_path), modules };
+    let json = serde_json::to_string_pretty(&manifest).map_err(|e| format!("Error serializing dependency manifest: {}", e))?;
+    write_if_changed(&out_dir.join("deps.json"), &json)
+}
+
 fn main() {
     let args: Vec<String> = env::args().collect();
     if args.len() < 2 {
-        eprintln!("Usage: redline-core <file.rl> [--json-ast | --gen <hpp|cpp>]");
+        eprintln!("Usage: redline-core <file.rl> [--json-ast | --gen <hpp|cpp>] [--profile[=timers]]");
+        eprintln!("       redline-core --gen-all <entry.rl> --out <dir> [--profile[=timers]]");
         process::exit(1);
     }
 
+    let profiling = Profiling::from_args(&args);
+
+    if args[1] == "--gen-all" {
+        let entry = args.get(2);
+        let out_dir = args.iter().position(|arg| arg == "--out").and_then(|pos| args.get(pos + 1));
+        match (entry, out_dir) {
+            (Some(entry), Some(out_dir)) => {
+                if let Err(message) = gen_all(entry, out_dir, profiling) {
+                    eprintln!("Error: {}", message);
+                    process::exit(1);
+                }
+            }
+            _ => {
+                eprintln!("Usage: redline-core --gen-all <entry.rl> --out <dir>");
+                process::exit(1);
+            }
+        }
+        return;
+    }
+
     let file_path_arg = &args[1];
     let module_name = Path::new(file_path_arg).file_stem().unwrap().to_str().unwrap();
 
@@ -59,31 +271,11 @@ fn main() {
         dump_json_ast = true;
     }
 
-    let content = match fs::read_to_string(file_path_arg) {
-        Ok(c) => c,
-        Err(e) => {
-            eprintln!("Error reading file [{}]: {}", file_path_arg, e);
-            process::exit(1);
-        }
-    };
-
-    let tokens = match Lexer::new(content.clone()).tokenize() {
-        Ok(t) => t,
-        Err(e) => {
-            report_error(file_path_arg, &content, &e.message, e.line, e.column);
-            process::exit(1);
-        }
-    };
-
-    let program = match Parser::new(&tokens).parse() {
-        Ok(p) => p,
-        Err(e) => {
-            report_error(file_path_arg, &content, &e.message, e.line, e.column);
-            process::exit(1);
-        }
-    };
-
     if dump_json_ast {
+        let program = match parse_file(file_path_arg, profiling) {
+            Ok(p) => p,
+            Err(_) => process::exit(1),
+        };
         match serde_json::to_string_pretty(&program) {
             Ok(json_str) => println!("{}", json_str),
             Err(e) => {
@@ -92,7 +284,19 @@ fn main() {
             }
         }
     } else {
-        match generate(&program, gen_mode, module_name) {
+        // The imported modules are parsed too, for the names they define.
+        let loaded = fs::canonicalize(file_path_arg)
+            .map_err(|e| format!("Error reading file [{}]: {}", file_path_arg, e))
+            .and_then(|path| load_program(&path, profiling));
+        let (mut modules, functions) = match loaded {
+            Ok(loaded) => loaded,
+            Err(message) => {
+                eprintln!("Error: {}", message);
+                process::exit(1);
+            }
+        };
+        let program = modules.pop().unwrap().program;
+        match generate(&program, gen_mode, module_name, &functions) {
             Ok(code) => println!("{}", code),
             Err(e) => {
                 eprintln!("Codegen Error: {}", e);
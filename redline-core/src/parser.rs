@@ -1,5 +1,5 @@
 use crate::lexer::{Lexer, Token, TokenType}; // Imported Lexer
-use crate::ast::{Program, Statement, Expression, Type, Literal, BinaryOperator, ClassMember};
+use crate::ast::{Program, Statement, Expression, Type, Literal, BinaryOperator, ClassKind, ClassMember, Parameter, ParamMode, Parallel, ReduceOp};
 
 #[derive(Debug)]
 pub struct ParserError {
@@ -17,23 +17,60 @@ impl std::fmt::Display for ParserError {
 pub struct Parser<'a> {
     tokens: &'a [Token],
     pos: usize,
+    /// Set for profiling builds: the source path recorded by `Statement::Line` markers.
+    line_file: Option<String>,
 }
 
 impl<'a> Parser<'a> {
     pub fn new(tokens: &'a [Token]) -> Self {
-        Self { tokens, pos: 0 }
+        Self { tokens, pos: 0, line_file: None }
+    }
+
+    /// Records the source line of every statement, for `#line` directives.
+    pub fn with_line_markers(mut self, file: &str) -> Self {
+        self.line_file = Some(file.to_string());
+        self
+    }
+
+    /// Pushes a `Statement::Line` for the statement about to be parsed. Definitions
+    /// and imports don't get one: they aren't code that runs in place.
+    fn mark_line(&self, statements: &mut Vec<Statement>) {
+        let Some(file) = &self.line_file else { return };
+        match self.current_token().token_type {
+            TokenType::Def | TokenType::Class | TokenType::Import | TokenType::At | TokenType::Pub => {}
+            _ if self.at_class_kind() => {}
+            _ => statements.push(Statement::Line { line: self.current_token().line, file: file.clone() }),
+        }
     }
 
     fn current_token(&self) -> Token {
         self.tokens.get(self.pos).cloned().unwrap_or_else(|| Token::new(TokenType::EOF, 0, 0))
     }
 
+    fn peek_token(&self) -> Token {
+        self.tokens.get(self.pos + 1).cloned().unwrap_or_else(|| Token::new(TokenType::EOF, 0, 0))
+    }
+
     fn advance(&mut self) {
         if self.pos < self.tokens.len() {
             self.pos += 1;
         }
     }
 
+    /// True at a contextual keyword: `word` followed by the name or expression it
+    /// applies to (`mut xs`, `struct Point`, `lock this.m`). Anywhere else, such as
+    /// `val lock: mutex = mutex()` or `move(a, b)`, the word is an ordinary identifier.
+    fn at_keyword(&self, word: &str) -> bool {
+        matches!(&self.current_token().token_type, TokenType::Ident(n) if n == word)
+            && matches!(self.peek_token().token_type, TokenType::Ident(_) | TokenType::This)
+    }
+
+    /// True at `struct Name` or `unique class`, the class kinds besides a plain `class`.
+    fn at_class_kind(&self) -> bool {
+        self.at_keyword("struct")
+            || matches!(&self.current_token().token_type, TokenType::Ident(n) if n == "unique") && self.peek_token().token_type == TokenType::Class
+    }
+
     fn consume_if(&mut self, token_type: TokenType) -> bool {
         if self.current_token().token_type == token_type {
             self.advance();
@@ -64,8 +101,10 @@ impl<'a> Parser<'a> {
                     "int" => { self.advance(); Ok(Type::Int) },
                     "float" => { self.advance(); Ok(Type::Float) },
                     "string" => { self.advance(); Ok(Type::String) },
+                    "str_view" => { self.advance(); Ok(Type::StrView) },
                     "bool" => { self.advance(); Ok(Type::Bool) },
                     "void" => { self.advance(); Ok(Type::Void) },
+                    "mapped_file" => { self.advance(); Ok(Type::MappedFile) },
                     "list" => {
                         self.advance();
                         self.expect(TokenType::LBracket, "Expected '[' after 'list'")?;
@@ -73,18 +112,39 @@ impl<'a> Parser<'a> {
                         self.expect(TokenType::RBracket, "Expected ']' after list inner type")?;
                         Ok(Type::List(Box::new(inner_type)))
                     },
-                    "dict" => {
+                    "dict" | "ordered_dict" => {
                         self.advance();
-                        self.expect(TokenType::LBracket, "Expected '[' after 'dict'")?;
+                        self.expect(TokenType::LBracket, &format!("Expected '[' after '{}'", ty_str))?;
                         let key_type = self.parse_type()?;
                         self.expect(TokenType::Comma, "Expected ',' after dictionary key type")?;
                         let value_type = self.parse_type()?;
                         self.expect(TokenType::RBracket, "Expected ']' after dictionary value type")?;
-                        Ok(Type::Dict(Box::new(key_type), Box::new(value_type)))
+                        if ty_str == "dict" {
+                            Ok(Type::Dict(Box::new(key_type), Box::new(value_type)))
+                        } else {
+                            Ok(Type::OrderedDict(Box::new(key_type), Box::new(value_type)))
+                        }
                     },
                     _ => Err(self.error(format!("Unknown built-in type: {}", ty_str))),
                 }
             },
+            // Concurrency types are contextual, so `mutex()` / `channel(n)` stay callable.
+            TokenType::Ident(name) if name == "mutex" => { self.advance(); Ok(Type::Mutex) },
+            TokenType::Ident(name) if name == "stopwatch" => { self.advance(); Ok(Type::Stopwatch) },
+            TokenType::Ident(name) if name == "file_entry" => { self.advance(); Ok(Type::FileEntry) },
+            TokenType::Ident(name) if name == "writer" => { self.advance(); Ok(Type::Writer) },
+            TokenType::Ident(name) if name == "task" || name == "atomic" || name == "channel" => {
+                let name = name.clone();
+                self.advance();
+                self.expect(TokenType::LBracket, &format!("Expected '[' after '{}'", name))?;
+                let inner = Box::new(self.parse_type()?);
+                self.expect(TokenType::RBracket, &format!("Expected ']' after {} element type", name))?;
+                Ok(match name.as_str() {
+                    "task" => Type::Task(inner),
+                    "atomic" => Type::Atomic(inner),
+                    _ => Type::Channel(inner),
+                })
+            },
             TokenType::Ident(name) => {
                 let name = name.clone();
                 self.advance();
@@ -108,7 +168,7 @@ impl<'a> Parser<'a> {
                     if chars[i] == '{' {
                         // Add string literal before '{'
                         if i > last_pos {
-                            let literal = s[last_pos..i].to_string();
+                            let literal: String = chars[last_pos..i].iter().collect();
                             parts.push(Expression::Literal(Literal::String(literal)));
                         }
 
@@ -123,19 +183,12 @@ impl<'a> Parser<'a> {
                         }
 
                         if brace_count == 0 {
-                            let expr_str = s[start_expr..i-1].to_string();
+                            let expr_str: String = chars[start_expr..i-1].iter().collect();
                             // Parse expression inside {}
                             let mut lexer = Lexer::new(expr_str);
                             let tokens = lexer.tokenize().map_err(|e| ParserError { message: e.message, line: token.line, column: token.column })?;
                             let mut parser = Parser::new(&tokens);
-                            let expr = parser.parse_expression()?;
-
-                            // Wrap in to_string()
-                            let to_string_call = Expression::Call {
-                                callee: Box::new(Expression::Identifier("to_string".to_string())),
-                                args: vec![expr]
-                            };
-                            parts.push(to_string_call);
+                            parts.push(parser.parse_expression()?);
                             last_pos = i;
                         } else {
                             return Err(self.error("Unclosed '{' in f-string".to_string()));
@@ -147,23 +200,15 @@ impl<'a> Parser<'a> {
 
                 // Add remaining string literal
                 if last_pos < chars.len() {
-                    let literal = s[last_pos..].to_string();
+                    let literal: String = chars[last_pos..].iter().collect();
                     parts.push(Expression::Literal(Literal::String(literal)));
                 }
 
-                // Combine parts with '+'
-                if parts.is_empty() {
-                    Ok(Expression::Literal(Literal::String("".to_string())))
-                } else {
-                    let mut final_expr = parts[0].clone();
-                    for j in 1..parts.len() {
-                        final_expr = Expression::BinaryOp {
-                            op: BinaryOperator::Add,
-                            left: Box::new(final_expr),
-                            right: Box::new(parts[j].clone())
-                        };
-                    }
-                    Ok(final_expr)
+                // A plain string needs no formatting at all.
+                match parts.as_slice() {
+                    [] => Ok(Expression::Literal(Literal::String("".to_string()))),
+                    [Expression::Literal(Literal::String(_))] => Ok(parts.remove(0)),
+                    _ => Ok(Expression::FormatString(parts)),
                 }
             },
             TokenType::New => {
@@ -185,7 +230,31 @@ impl<'a> Parser<'a> {
                     Err(self.error("Expected class name after 'new'".to_string()))
                 }
             },
+            // `list[T](capacity)`: the one type that can be called like a constructor.
+            TokenType::Type(ty) if ty == "list" => {
+                let element_type = match self.parse_type()? {
+                    Type::List(inner) => *inner,
+                    _ => unreachable!(),
+                };
+                self.expect(TokenType::LParen, "Expected '(' and a capacity after list type")?;
+                let capacity = self.parse_expression()?;
+                self.expect(TokenType::RParen, "Expected ')' after list capacity")?;
+                Ok(Expression::ListWithCapacity { element_type, capacity: Box::new(capacity) })
+            },
             TokenType::This => { self.advance(); Ok(Expression::This) },
+            TokenType::Ident(_) if self.at_keyword("move") => {
+                self.advance();
+                let value = self.parse_expression_primary()?;
+                Ok(Expression::Move(Box::new(value)))
+            },
+            TokenType::Ident(_) if self.at_keyword("spawn") => {
+                self.advance();
+                let call = self.parse_expression_primary()?;
+                if !matches!(call, Expression::Call { .. }) {
+                    return Err(self.error("Expected a function call after 'spawn'".to_string()));
+                }
+                Ok(Expression::Spawn(Box::new(call)))
+            },
             TokenType::Int(n) => { self.advance(); Ok(Expression::Literal(Literal::Int(*n))) },
             TokenType::Float(n) => { self.advance(); Ok(Expression::Literal(Literal::Float(*n))) },
             TokenType::Str(s) => { self.advance(); Ok(Expression::Literal(Literal::String(s.clone()))) },
@@ -336,6 +405,7 @@ impl<'a> Parser<'a> {
         while self.current_token().token_type != TokenType::Dedent && self.current_token().token_type != TokenType::EOF {
             while self.consume_if(TokenType::Newline) {}
             if self.current_token().token_type == TokenType::Dedent { break; }
+            self.mark_line(&mut statements);
             statements.push(self.parse_statement()?);
         }
         self.expect(TokenType::Dedent, "Expected dedent to end block")?;
@@ -392,6 +462,7 @@ impl<'a> Parser<'a> {
     }
 
     fn parse_function_definition(&mut self, is_public: bool) -> Result<Statement, ParserError> {
+        let def_line = self.current_token().line;
         self.expect(TokenType::Def, "Expected 'def'")?;
         let name = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
             else { return Err(self.error("Expected function name after 'def'".to_string())); };
@@ -401,12 +472,18 @@ impl<'a> Parser<'a> {
         let mut params = Vec::new();
         if !self.consume_if(TokenType::RParen) {
             loop {
+                let mode = if self.at_keyword("mut") { ParamMode::Mut }
+                    else if self.at_keyword("move") { ParamMode::Move }
+                    else { ParamMode::Default };
+                if mode != ParamMode::Default {
+                    self.advance();
+                }
                 let param_name = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
                     else { return Err(self.error("Expected parameter name".to_string())); };
                 self.advance();
                 self.expect(TokenType::Colon, "Expected ':' after parameter name")?;
                 let param_type = self.parse_type()?;
-                params.push((param_name, param_type));
+                params.push(Parameter { name: param_name, data_type: param_type, mode });
                 if !self.consume_if(TokenType::Comma) { break; }
             }
             self.expect(TokenType::RParen, "Expected ')' after parameters")?;
@@ -420,8 +497,34 @@ impl<'a> Parser<'a> {
 
         self.expect(TokenType::Colon, "Expected ':' after function signature")?;
         self.expect(TokenType::Newline, "Expected newline after function definition")?;
-        let body = self.parse_block()?;
-        Ok(Statement::FunctionDefinition { is_public, name, params, return_type, body })
+        let mut body = self.parse_block()?;
+        // The function's own line leads its body, so the prologue maps to the `def`.
+        if let Some(file) = &self.line_file {
+            body.insert(0, Statement::Line { line: def_line, file: file.clone() });
+        }
+        Ok(Statement::FunctionDefinition { is_public, is_bench: false, name, params, return_type, body })
+    }
+
+    /// `@bench` on the line before a `def`.
+    fn parse_decorated_function(&mut self) -> Result<Statement, ParserError> {
+        self.expect(TokenType::At, "Expected '@'")?;
+        match &self.current_token().token_type {
+            TokenType::Ident(n) if n == "bench" => self.advance(),
+            _ => return Err(self.error("Unknown decorator: only '@bench' is supported".to_string())),
+        }
+        self.expect(TokenType::Newline, "Expected newline after '@bench'")?;
+        let is_public = self.consume_if(TokenType::Pub);
+        if self.current_token().token_type != TokenType::Def {
+            return Err(self.error("Expected a function definition after '@bench'".to_string()));
+        }
+        let mut function = self.parse_function_definition(is_public)?;
+        if let Statement::FunctionDefinition { is_bench, params, .. } = &mut function {
+            if !params.is_empty() {
+                return Err(self.error("'@bench' functions can't take parameters".to_string()));
+            }
+            *is_bench = true;
+        }
+        Ok(function)
     }
 
     fn parse_if_statement(&mut self) -> Result<Statement, ParserError> {
@@ -448,19 +551,74 @@ impl<'a> Parser<'a> {
         Ok(Statement::While { condition, body })
     }
 
-    fn parse_for_statement(&mut self) -> Result<Statement, ParserError> {
+    fn parse_for_statement(&mut self, is_parallel: bool) -> Result<Statement, ParserError> {
         self.expect(TokenType::For, "Expected 'for'")?;
+        let is_mutable = self.at_keyword("mut");
+        if is_mutable {
+            self.advance();
+        }
         let iterator = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
             else { return Err(self.error("Expected iterator name after 'for'".to_string())); };
         self.advance();
+        let value = if self.consume_if(TokenType::Comma) {
+            let n = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
+                else { return Err(self.error("Expected value name after ',' in 'for'".to_string())); };
+            self.advance();
+            Some(n)
+        } else { None };
         self.expect(TokenType::In, "Expected 'in' after iterator")?;
         let start = self.parse_expression()?;
-        self.expect(TokenType::Range, "Expected '..' range operator")?;
+        if self.current_token().token_type != TokenType::Range {
+            if is_parallel {
+                return Err(self.error("'parallel for' needs a range: parallel for i in start..end:".to_string()));
+            }
+            self.expect(TokenType::Colon, "Expected '..' range operator or ':' after iterable")?;
+            self.expect(TokenType::Newline, "Expected newline after for colon")?;
+            let body = self.parse_block()?;
+            return Ok(Statement::ForEach { iterator, value, is_mutable, iterable: start, body });
+        }
+        if is_mutable || value.is_some() {
+            return Err(self.error("A range 'for' takes a single iterator: for i in start..end:".to_string()));
+        }
+        self.advance();
         let end = self.parse_expression()?;
+        let parallel = if is_parallel { Some(Parallel { reduction: self.parse_reduction()? }) } else { None };
         self.expect(TokenType::Colon, "Expected ':' after range")?;
         self.expect(TokenType::Newline, "Expected newline after for colon")?;
         let body = self.parse_block()?;
-        Ok(Statement::For { iterator, start, end, body })
+        Ok(Statement::For { iterator, start, end, parallel, body })
+    }
+
+    /// `reduce sum into total`, after a parallel for's range. The words are
+    /// contextual, so they stay usable as ordinary names everywhere else.
+    fn parse_reduction(&mut self) -> Result<Option<(ReduceOp, String)>, ParserError> {
+        if !self.consume_word("reduce") {
+            return Ok(None);
+        }
+        let op = match &self.current_token().token_type {
+            TokenType::Ident(n) if n == "sum" => ReduceOp::Sum,
+            TokenType::Ident(n) if n == "product" => ReduceOp::Product,
+            TokenType::Ident(n) if n == "min" => ReduceOp::Min,
+            TokenType::Ident(n) if n == "max" => ReduceOp::Max,
+            _ => return Err(self.error("Expected 'sum', 'product', 'min' or 'max' after 'reduce'".to_string())),
+        };
+        self.advance();
+        if !self.consume_word("into") {
+            return Err(self.error("Expected 'into' after reduction operator".to_string()));
+        }
+        let target = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
+            else { return Err(self.error("Expected variable name after 'into'".to_string())); };
+        self.advance();
+        Ok(Some((op, target)))
+    }
+
+    fn consume_word(&mut self, word: &str) -> bool {
+        if matches!(&self.current_token().token_type, TokenType::Ident(n) if n == word) {
+            self.advance();
+            true
+        } else {
+            false
+        }
     }
 
     fn parse_import_statement(&mut self) -> Result<Statement, ParserError> {
@@ -475,14 +633,25 @@ impl<'a> Parser<'a> {
     }
 
     fn parse_class_statement(&mut self, is_public: bool) -> Result<Statement, ParserError> {
-        self.expect(TokenType::Class, "Expected 'class'")?;
+        let kind = match &self.current_token().token_type {
+            TokenType::Ident(n) if n == "struct" => { self.advance(); ClassKind::Value },
+            TokenType::Ident(n) if n == "unique" => {
+                self.advance();
+                self.expect(TokenType::Class, "Expected 'class' after 'unique'")?;
+                ClassKind::Unique
+            },
+            _ => {
+                self.expect(TokenType::Class, "Expected 'class'")?;
+                ClassKind::Shared
+            },
+        };
         let name = if let TokenType::Ident(n) = &self.current_token().token_type { n.clone() }
             else { return Err(self.error("Expected class name".to_string())); };
         self.advance();
         self.expect(TokenType::Colon, "Expected ':' after class name")?;
         self.expect(TokenType::Newline, "Expected newline after class definition")?;
         let members = self.parse_class_block()?;
-        Ok(Statement::Class { is_public, name, members })
+        Ok(Statement::Class { is_public, kind, name, members })
     }
 
     fn parse_try_catch_statement(&mut self) -> Result<Statement, ParserError> {
@@ -506,13 +675,43 @@ impl<'a> Parser<'a> {
         Ok(Statement::TryCatch { try_block, catch_var, catch_block })
     }
 
+    fn parse_with_statement(&mut self) -> Result<Statement, ParserError> {
+        self.advance(); // `with`
+        match &self.current_token().token_type {
+            TokenType::Ident(n) if n == "arena" => self.advance(),
+            _ => return Err(self.error("Expected 'arena' after 'with'".to_string())),
+        }
+        let mut initial_size = None;
+        if self.consume_if(TokenType::LParen) {
+            initial_size = Some(self.parse_expression()?);
+            self.expect(TokenType::RParen, "Expected ')' after arena size")?;
+        }
+        self.expect(TokenType::Colon, "Expected ':' after 'with arena'")?;
+        self.expect(TokenType::Newline, "Expected newline after 'with arena:'")?;
+        let body = self.parse_block()?;
+        Ok(Statement::Arena { initial_size, body })
+    }
+
+    fn parse_lock_statement(&mut self) -> Result<Statement, ParserError> {
+        self.advance(); // `lock`
+        let mutex = self.parse_expression()?;
+        self.expect(TokenType::Colon, "Expected ':' after lock target")?;
+        self.expect(TokenType::Newline, "Expected newline after 'lock ...:'")?;
+        let body = self.parse_block()?;
+        Ok(Statement::Lock { mutex, body })
+    }
+
     fn parse_statement(&mut self) -> Result<Statement, ParserError> {
         while self.consume_if(TokenType::Newline) {}
 
         match self.current_token().token_type {
             TokenType::Import => self.parse_import_statement(),
             TokenType::Class => self.parse_class_statement(false),
+            _ if self.at_class_kind() => self.parse_class_statement(false),
             TokenType::Try => self.parse_try_catch_statement(),
+            _ if self.at_keyword("with") => self.parse_with_statement(),
+            _ if self.at_keyword("lock") => self.parse_lock_statement(),
+            TokenType::At => self.parse_decorated_function(),
             TokenType::Break => {
                 self.advance();
                 Ok(Statement::Break)
@@ -524,9 +723,15 @@ impl<'a> Parser<'a> {
             TokenType::Print => {
                 self.advance();
                 self.expect(TokenType::LParen, "Expected '(' after 'print'")?;
-                let arg = self.parse_expression()?;
-                self.expect(TokenType::RParen, "Expected ')' after print argument")?;
-                Ok(Statement::Print(arg))
+                let mut args = Vec::new();
+                if !self.consume_if(TokenType::RParen) {
+                    loop {
+                        args.push(self.parse_expression()?);
+                        if !self.consume_if(TokenType::Comma) { break; }
+                    }
+                    self.expect(TokenType::RParen, "Expected ')' after print arguments")?;
+                }
+                Ok(Statement::Print(args))
             },
             TokenType::Pub => {
                 self.advance();
@@ -534,14 +739,19 @@ impl<'a> Parser<'a> {
                     TokenType::Val | TokenType::Var => self.parse_declaration(true),
                     TokenType::Def => self.parse_function_definition(true),
                     TokenType::Class => self.parse_class_statement(true),
-                    _ => Err(self.error("Expected 'val', 'var', 'def', or 'class' after 'pub'".to_string())),
+                    _ if self.at_class_kind() => self.parse_class_statement(true),
+                    _ => Err(self.error("Expected 'val', 'var', 'def', 'class', or 'struct' after 'pub'".to_string())),
                 }
             },
             TokenType::Val | TokenType::Var => self.parse_declaration(false),
             TokenType::Def => self.parse_function_definition(false),
             TokenType::If => self.parse_if_statement(),
             TokenType::While => self.parse_while_statement(),
-            TokenType::For => self.parse_for_statement(),
+            TokenType::For => self.parse_for_statement(false),
+            TokenType::Ident(ref n) if n == "parallel" && self.peek_token().token_type == TokenType::For => {
+                self.advance();
+                self.parse_for_statement(true)
+            },
             TokenType::Return => {
                 self.advance();
                 let expr = if self.current_token().token_type == TokenType::Newline || self.current_token().token_type == TokenType::EOF { None }
@@ -564,6 +774,7 @@ impl<'a> Parser<'a> {
         let mut statements = Vec::new();
         while self.current_token().token_type != TokenType::EOF {
             if self.consume_if(TokenType::Newline) { continue; }
+            self.mark_line(&mut statements);
             statements.push(self.parse_statement()?);
         }
         Ok(Program { statements })
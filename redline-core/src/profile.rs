@@ -0,0 +1,48 @@
+//! Instrumentation for `redline build --profile=timers`: every function body
+//! gets a scope timer, and the program prints a per-function table at exit.
+//! Runs on a program parsed with line markers, which give each timer its location.
+use crate::ast::{ClassMember, Program, Statement};
+use std::path::Path;
+
+pub fn insert_scope_timers(program: &mut Program) {
+    let runs_main = program.statements.iter().any(|s| {
+        !matches!(s, Statement::FunctionDefinition { .. } | Statement::Import(_) | Statement::Class { .. } | Statement::Line { .. })
+    });
+    for stmt in &mut program.statements {
+        match stmt {
+            Statement::FunctionDefinition { name, body, .. } => time_body(name.clone(), body),
+            Statement::Class { name: class_name, members, .. } => {
+                for member in members {
+                    if let ClassMember::Method(Statement::FunctionDefinition { name, body, .. })
+                    | ClassMember::Constructor(Statement::FunctionDefinition { name, body, .. }) = member {
+                        time_body(format!("{}.{}", class_name, name), body);
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    // The top-level statements are main()'s body; a module of only definitions has no main().
+    if runs_main {
+        let location = program.statements.iter().find_map(line_location).unwrap_or_default();
+        program.statements.insert(0, Statement::ProfileScope { name: "main".to_string(), location });
+    }
+}
+
+/// Puts the timer after the body's leading `Line` (the `def` itself), so it is
+/// reported at the function's line.
+fn time_body(name: String, body: &mut Vec<Statement>) {
+    let location = body.first().and_then(line_location).unwrap_or_default();
+    let at = if matches!(body.first(), Some(Statement::Line { .. })) { 1 } else { 0 };
+    body.insert(at, Statement::ProfileScope { name, location });
+}
+
+fn line_location(stmt: &Statement) -> Option<String> {
+    match stmt {
+        Statement::Line { line, file } => {
+            let file_name = Path::new(file).file_name().map_or(file.clone(), |n| n.to_string_lossy().to_string());
+            Some(format!("{}:{}", file_name, line))
+        }
+        _ => None,
+    }
+}
@@ -5,6 +5,11 @@ import sys
 import json
 import re
 import shutil
+import hashlib
+import platform
+import threading
+from datetime import datetime, timezone
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
 from pathlib import Path
 try:
     import tomllib
@@ -23,6 +28,37 @@ PROJECT_ROOT = Path(os.path.dirname(os.path.realpath(__file__)))
 CORE_DIR = PROJECT_ROOT / "redline-core"
 CORE_BIN = CORE_DIR / "target" / "release" / "redline-core"
 BUILD_DIR = PROJECT_ROOT / "temp_build"
+# The whole runtime, precompiled once per set of compiler flags (see Compiler.build_pch).
+PCH_HEADER = PROJECT_ROOT / "stdlib" / "rl_stdlib_all.hpp"
+# `bench-suite` kernels: benchmarks/<name>.rl, each timed against benchmarks/reference/<name>.cpp.
+BENCH_SUITE_DIR = PROJECT_ROOT / "benchmarks"
+
+# Default build profiles. Any key can be overridden per project in
+# RedConfig.toml under [profile.debug] / [profile.release].
+DEFAULT_PROFILES = {
+    "debug": {
+        "opt_level": "0",
+        "debug_info": True,
+        "march": None,
+        "lto": False,
+        "ndebug": False,
+        "strip": False,
+        "pch": True,
+        "unity": False,
+        "static": False,
+    },
+    "release": {
+        "opt_level": "3",
+        "debug_info": False,
+        "march": "native",
+        "lto": True,
+        "ndebug": True,
+        "strip": True,
+        "pch": True,
+        "unity": False,
+        "static": False,
+    },
+}
 
 ASCII_ART = r"""
 ██████╗ ███████╗██████╗ ██╗     ██╗███╗   ██╗███████╗
@@ -40,86 +76,273 @@ def print_usage():
     print("---------------------------------")
     print("A high-performance, transpiled systems language.")
     print("\nUsage:")
-    print("  python redline.py <command> [arguments]")
+    print("  python redline.py <command> [arguments] [options]")
     print("\nCommands:")
     print("  build [file]    Compile a REDLINE project or a single file.")
     print("  parse <file.rl> Generate C++ code from a REDLINE file without compiling.")
     print("  lib <file.rl>   Compile a REDLINE file into a static library (.o).")
+    print("  bench <file.rl> [filter]  Build optimized and run the file's @bench functions.")
+    print("  bench-suite [kernel]      Time benchmarks/*.rl against their C++ references, write JSON (--out PATH).")
+    print("  clean           Delete the build cache so the next build starts from scratch.")
     print("  init            Initialize and build the REDLINE compiler core.")
     print("  help            Show this help message.")
+    print("\nOptions:")
+    print("  --release       Use the release profile (optimized, LTO, stripped).")
+    print("  --profile       Build optimized for perf/gdb: symbols, frame pointers, #line back to the .rl sources.")
+    print("  --profile=timers  Like --profile, and print a per-function time table at exit.")
+    print("  --unity         Compile all modules as one translation unit, for inlining across them.")
+    print("  --static        Link the executable statically, for the fastest startup.")
+    print("  --pgo           Release build with profile-guided optimization, trained by [pgo] train.")
+    print("  -j N            Run up to N compile jobs in parallel (default: CPU count).")
 
 class Module:
     """Represents a single REDLINE module (a .rl file)."""
-    def __init__(self, source_path, ast):
+    def __init__(self, source_path, build_dir, imports):
         self.source_path = source_path
-        self.ast = ast
+        self.imports = imports
         self.name = source_path.stem
-        self.cpp_path = BUILD_DIR / f"{self.name}.cpp"
-        self.hpp_path = BUILD_DIR / f"{self.name}.hpp"
-        self.obj_path = BUILD_DIR / f"{self.name}.o"
+        self.cpp_path = build_dir / f"{self.name}.cpp"
+        self.hpp_path = build_dir / f"{self.name}.hpp"
+        self.dependencies = [] # Modules this one imports, filled in during analysis
 
     def get_imports(self):
-        """Extracts import paths from the module's AST."""
-        imports = []
-        for statement in self.ast.get('statements', []):
-            if 'Import' in statement:
-                imports.append(statement['Import'])
-        return imports
+        """Returns the import paths declared by the module."""
+        return self.imports
+
+    def obj_path(self, profile):
+        """Object files live in a per-profile subdirectory so switching profiles doesn't evict them."""
+        return self.cpp_path.parent / profile["name"] / f"{self.name}.o"
+
+class UnityModule(Module):
+    """
+    A program's generated modules pasted into one translation unit, for
+    `unity = true`, so g++ can inline across module boundaries without LTO.
+    Its object depends on everything it pastes in, so it is keyed like a
+    module that imports all of them.
+    """
+    def __init__(self, entry, modules, build_dir):
+        super().__init__(entry.source_path, build_dir / "unity", [])
+        self.source_path = self.cpp_path  # Its own build cache entry, apart from the entry module's
+        self.hpp_path = entry.hpp_path
+        # A fixed order, so the same program always gives the same text and a cache hit.
+        self.dependencies = sorted(modules, key=lambda m: str(m.source_path))
+
+    def write(self):
+        """Writes the combined .cpp. Each module includes its headers by name, so only their guards matter."""
+        text = "".join(module.cpp_path.read_text() for module in self.dependencies)
+        self.cpp_path.parent.mkdir(parents=True, exist_ok=True)
+        if not self.cpp_path.exists() or self.cpp_path.read_text() != text:
+            self.cpp_path.write_text(text)
+
+def hash_bytes(*parts):
+    """Returns a hex SHA-256 over the given byte/str parts."""
+    digest = hashlib.sha256()
+    for part in parts:
+        digest.update(part.encode() if isinstance(part, str) else part)
+        digest.update(b"\0")
+    return digest.hexdigest()
+
+class BuildCache:
+    """
+    Persistent record of what was generated and compiled for one project.
+
+    Code generation is keyed by the content hash of each .rl file (plus the core
+    binary), and object files are keyed by the generated code, the interfaces
+    (.hpp) of the modules it imports, the stdlib headers and the compiler flags.
+    """
+    def __init__(self, cache_dir, core_bin_path):
+        self.cache_dir = cache_dir
+        self.manifest_path = cache_dir / "cache.json"
+        self.entries = {}
+        if self.manifest_path.exists():
+            try:
+                self.entries = json.loads(self.manifest_path.read_text()).get("modules", {})
+            except json.JSONDecodeError:
+                print("Warning: Build cache manifest is corrupt, rebuilding everything.")
+        self.core_hash = hash_bytes(core_bin_path.read_bytes())
+        stdlib_files = sorted((PROJECT_ROOT / "stdlib").glob("*.hpp"))
+        self.stdlib_hash = hash_bytes(*(f.read_bytes() for f in stdlib_files))
+
+    def entry(self, module_path):
+        return self.entries.setdefault(str(module_path), {})
+
+    def codegen_key(self, source_path):
+        return hash_bytes(source_path.read_bytes(), self.core_hash)
+
+    def object_key(self, module, flags):
+        interfaces = [dep.hpp_path.read_bytes() for dep in sorted(module.dependencies, key=lambda m: m.name)]
+        return hash_bytes(module.cpp_path.read_bytes(), module.hpp_path.read_bytes(), *interfaces, self.stdlib_hash, " ".join(flags))
+
+    def save(self):
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        self.manifest_path.write_text(json.dumps({"modules": self.entries}, indent=2))
 
 class Compiler:
     """Orchestrates the compilation of a REDLINE project."""
 
-    def __init__(self, core_bin_path):
+    def __init__(self, core_bin_path, cache, core_args=()):
         self.core_bin_path = core_bin_path
+        self.core_args = list(core_args) # Extra codegen flags, e.g. --profile
+        self.cache = cache
+        self.build_dir = cache.cache_dir
         self.modules = {} # Cache for compiled modules: path -> Module
+        self.pch_flags = [] # Force-include of the precompiled stdlib, once build_pch has made it
 
-    def get_ast(self, source_file):
-        """Runs the core parser and returns the AST as a JSON object."""
-        try:
-            result = subprocess.run(
-                [str(self.core_bin_path), str(source_file), "--json-ast"],
-                capture_output=True, text=True, check=True,
-            )
-            return json.loads(result.stdout)
-        except (subprocess.CalledProcessError, json.JSONDecodeError) as e:
-            print(f"Error: Failed to parse {source_file.name}.")
-            if hasattr(e, 'stderr') and e.stderr: print(e.stderr, file=sys.stderr)
-            return None
-
-    def compile_module_recursive(self, source_path):
-        """Recursively compiles a module and its dependencies."""
+    def load_cached_module(self, source_path):
+        """Recursively rebuilds the module graph from the cache. Returns None if any module's generated code is stale."""
+        source_path = source_path.resolve()
         if source_path in self.modules:
             return self.modules[source_path]
-
-        print(f"  -> Analyzing module: {source_path.name}")
-        ast = self.get_ast(source_file)
-        if not ast:
+        if not source_path.exists():
             return None
 
-        module = Module(source_path, ast)
+        entry = self.cache.entry(source_path)
+        module = Module(source_path, self.build_dir, entry.get("imports", []))
+        if entry.get("codegen_key") != self.cache.codegen_key(source_path) or not module.hpp_path.exists() or not module.cpp_path.exists():
+            return None
         self.modules[source_path] = module
 
-        for import_path_str in module.get_imports():
-            import_path = source_path.parent / import_path_str
-            if not self.compile_module_recursive(import_path):
+        for dependency_path in entry.get("dependencies", []):
+            dependency = self.load_cached_module(Path(dependency_path))
+            if not dependency:
                 return None
-        
+            module.dependencies.append(dependency)
         return module
 
-    def generate_code(self, module, mode):
-        """Generates .cpp or .hpp file for a single module."""
-        output_path = module.cpp_path if mode == "cpp" else module.hpp_path
+    def generate_all(self, entry_path):
+        """Runs the core once in batch mode to parse and generate every module reachable from the entry point."""
         try:
-            result = subprocess.run(
-                [str(self.core_bin_path), str(module.source_path), "--gen", mode],
+            subprocess.run(
+                [str(self.core_bin_path), "--gen-all", str(entry_path), "--out", str(self.build_dir), *self.core_args],
                 capture_output=True, text=True, check=True,
             )
-            output_path.write_text(result.stdout)
+            deps = json.loads((self.build_dir / "deps.json").read_text())
+        except (subprocess.CalledProcessError, json.JSONDecodeError) as e:
+            print("Error: Code generation failed.")
+            if hasattr(e, 'stderr') and e.stderr: print(e.stderr, file=sys.stderr)
+            return None
+
+        self.modules = {}
+        for info in deps["modules"]:
+            source_path = Path(info["source"]).resolve()
+            self.modules[source_path] = Module(source_path, self.build_dir, info["imports"])
+            print(f"  -> Generated module: {source_path.name}")
+        for info in deps["modules"]:
+            module = self.modules[Path(info["source"]).resolve()]
+            module.dependencies = [self.modules[Path(dep).resolve()] for dep in info["dependencies"]]
+            entry = self.cache.entry(module.source_path)
+            entry["codegen_key"] = self.cache.codegen_key(module.source_path)
+            entry["imports"] = module.imports
+            entry["dependencies"] = [str(dep.source_path) for dep in module.dependencies]
+        return self.modules[Path(deps["entry"]).resolve()]
+
+    def load_project(self, entry_path):
+        """Returns the entry module with its dependency graph, regenerating C++ only if some module changed."""
+        module = self.load_cached_module(entry_path)
+        if module:
+            print("  -> All modules up to date")
+            return module
+        self.modules = {}
+        return self.generate_all(entry_path)
+
+    def build_pch(self, profile):
+        """
+        Precompiles stdlib/rl_stdlib_all.hpp for this profile's flags, unless an
+        earlier build (of any project) already did. A .gch only works with the
+        flags it was built with, so each set of flags gets its own directory,
+        shared between projects. On failure the build carries on without it.
+        """
+        flags = compile_flags(profile)
+        pch_dir = BUILD_DIR / "pch" / hash_bytes(self.cache.stdlib_hash, " ".join(flags))[:16]
+        header = pch_dir / PCH_HEADER.name
+        gch = pch_dir / f"{PCH_HEADER.name}.gch"
+        if not gch.exists():
+            log("  -> Precompiling the stdlib header")
+            pch_dir.mkdir(parents=True, exist_ok=True)
+            # g++ looks for the .gch next to the header it is asked to include, and
+            # falls back to that header (which includes the real ones) if it can't be used.
+            shutil.copyfile(PCH_HEADER, header)
+            partial = pch_dir / f"{gch.name}.{os.getpid()}"
+            try:
+                subprocess.run(
+                    ["g++", *flags, "-x", "c++-header", str(header), "-o", str(partial), f"-I{PROJECT_ROOT}"],
+                    check=True, capture_output=True, text=True,
+                )
+            except subprocess.CalledProcessError as e:
+                log("Warning: Could not precompile the stdlib header, compiling without it.", e.stderr)
+                partial.unlink(missing_ok=True)
+                return True
+            os.replace(partial, gch)  # Atomic, so a concurrent build never reads half a file.
+        self.pch_flags = ["-include", str(header)]
+        return True
+
+    def compile_object(self, module, profile):
+        """Compiles a module's .cpp into an object file, reusing the cached one when nothing it depends on changed."""
+        flags = compile_flags(profile) + self.pch_flags
+        obj_path = module.obj_path(profile)
+        object_key = self.cache.object_key(module, flags)
+        objects = self.cache.entry(module.source_path).setdefault("objects", {})
+        if objects.get(profile["name"]) == object_key and obj_path.exists():
+            log(f"  -> {module.name}.o is up to date")
             return True
+
+        log(f"  -> Compiling {module.name}.o")
+        obj_path.parent.mkdir(parents=True, exist_ok=True)
+        try:
+            # Output is captured so that parallel jobs don't interleave their diagnostics.
+            subprocess.run(
+                ["g++", *flags, "-c", str(module.cpp_path), "-o", str(obj_path), f"-I{self.build_dir}", f"-I{PROJECT_ROOT}"],
+                check=True, capture_output=True, text=True,
+            )
         except subprocess.CalledProcessError as e:
-            print(f"Error: Failed to generate {mode.upper()} for {module.name}.")
-            if hasattr(e, 'stderr') and e.stderr: print(e.stderr, file=sys.stderr)
+            log(f"Compilation failed for {module.name}: {e}", e.stderr)
             return False
+        objects[profile["name"]] = object_key
+        return True
+
+_log_lock = threading.Lock()
+
+def log(message, stderr_text=None):
+    """Prints a message (and optional captured stderr) without interleaving with other jobs."""
+    with _log_lock:
+        print(message)
+        if stderr_text:
+            print(stderr_text, file=sys.stderr)
+
+def run_task_graph(tasks, jobs):
+    """
+    Runs a DAG of tasks on a pool of `jobs` worker threads.
+
+    `tasks` maps a task key to `(function, [dependency keys])`. A task is started as
+    soon as all of its dependencies have succeeded; the function returns True on
+    success. Stops scheduling new work after the first failure.
+    """
+    pending = {key: set(deps) for key, (_, deps) in tasks.items()}
+    succeeded = set()
+    failed = False
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        running = {}
+
+        def submit_ready():
+            for key in [k for k, deps in pending.items() if deps <= succeeded]:
+                del pending[key]
+                running[pool.submit(tasks[key][0])] = key
+
+        submit_ready()
+        while running:
+            finished, _ = wait(running, return_when=FIRST_COMPLETED)
+            for future in finished:
+                key = running.pop(future)
+                if future.result():
+                    succeeded.add(key)
+                else:
+                    failed = True
+            if not failed:
+                submit_ready()
+
+    if pending and not failed:
+        print("Error: Some build steps have circular dependencies and were never run.")
+    return not failed and not pending
 
 def init_core():
     """Initializes the REDLINE compiler core."""
@@ -154,6 +377,186 @@ def init_core():
         print(f"An unexpected error occurred: {e}")
         return False
 
+def load_profile(config, release):
+    """Merges the [profile.<name>] table from RedConfig.toml over the defaults."""
+    name = "release" if release else "debug"
+    profile = dict(DEFAULT_PROFILES[name])
+    overrides = config.get("profile", {}).get(name, {}) if config else {}
+    for key, value in overrides.items():
+        if key not in profile:
+            print(f"Warning: Unknown key '{key}' in [profile.{name}], ignoring.")
+            continue
+        profile[key] = value
+    profile["name"] = name
+    return profile
+
+def compile_flags(profile):
+    """Returns the g++ flags used when compiling a translation unit."""
+    flags = ["-std=c++17", f"-O{profile['opt_level']}", "-pthread"]
+    if profile["debug_info"]:
+        flags.append("-g")
+    if profile["march"]:
+        flags.append(f"-march={profile['march']}")
+    if profile["lto"]:
+        flags.append("-flto")
+        if profile.get("fat_lto"):
+            flags.append("-ffat-lto-objects")  # Also real machine code, for linkers that don't do LTO
+    if profile["ndebug"]:
+        flags.append("-DNDEBUG")
+    if profile.get("frame_pointers"):
+        flags.append("-fno-omit-frame-pointer")  # So perf can walk the call stack
+    if profile.get("bench"):
+        flags.append("-DRL_BENCH")
+    if profile.get("pgo") == "generate":
+        # Atomic counters where the target has them, so spawn and parallel for don't lose counts.
+        flags.extend(["-fprofile-generate", "-fprofile-update=prefer-atomic"])
+    if profile.get("pgo") == "use":
+        # Code the training run never reached is still optimized normally, not for size.
+        flags.extend(["-fprofile-use", "-fprofile-partial-training"])
+    return flags
+
+def link_flags(profile):
+    """Returns the g++ flags used when linking the final executable."""
+    flags = ["-pthread"]  # rl_thread.hpp / rl_parallel.hpp: spawn, channels, the parallel for pool
+    if profile["lto"]:
+        # The optimization level must be repeated at link time for LTO to honour it.
+        flags.extend(["-flto", f"-O{profile['opt_level']}"])
+        if profile["march"]:
+            flags.append(f"-march={profile['march']}")
+    if profile.get("pgo") == "generate":
+        flags.append("-fprofile-generate")  # Links libgcov, which writes the .gcda files at exit
+    if profile.get("pgo") == "use" and profile["lto"]:
+        flags.append("-fprofile-use")
+    if profile["strip"]:
+        flags.append("-s")
+    if profile["static"]:
+        flags.append("-static")  # No dynamic loader or shared-library relocations at startup
+    return flags
+
+def build_objects(source_file, project_name, profile, core_args, jobs, codegen_only=False):
+    """Generates and compiles every module of a program. Returns (cache_dir, modules), or None on failure."""
+    # Each entry point gets its own cache directory so projects can't evict each other.
+    cache_dir = BUILD_DIR / f"{project_name}-{hash_bytes(str(source_file), *core_args)[:12]}"
+    cache = BuildCache(cache_dir, CORE_BIN)
+    compiler = Compiler(CORE_BIN, cache, core_args)
+    cache_dir.mkdir(parents=True, exist_ok=True)
+    try:
+        main_module = compiler.load_project(source_file)
+        if not main_module:
+            print("Build failed during code generation.")
+            return None
+        all_modules = list(compiler.modules.values())
+        if codegen_only:
+            return cache_dir, all_modules
+        if profile["unity"]:
+            unity = UnityModule(main_module, all_modules, cache_dir)
+            unity.write()
+            all_modules = [unity]
+
+        # All headers exist at this point, so every module's object can be compiled independently.
+        tasks = {module: (lambda m=module: compiler.compile_object(m, profile), ["pch"] if profile["pch"] else []) for module in all_modules}
+        if profile["pch"]:
+            tasks["pch"] = (lambda: compiler.build_pch(profile), [])
+
+        print(f"Compiling object files ({profile['name']} profile, {jobs} jobs)...")
+        if not run_task_graph(tasks, jobs):
+            print("Build failed.")
+            return None
+        return cache_dir, all_modules
+    finally:
+        cache.save()
+
+def link_executable(modules, profile, exe_path):
+    """Links the modules' object files into an executable. Returns True on success."""
+    obj_files = [str(m.obj_path(profile)) for m in modules]
+    try:
+        subprocess.run(["g++", *obj_files, *link_flags(profile), "-o", str(exe_path)], check=True)
+        return True
+    except subprocess.CalledProcessError as e:
+        print(f"G++ linking failed: {e}")
+        return False
+
+def build_with_pgo(source_file, project_name, profile, config, train_dir, exe_output, jobs):
+    """
+    Builds an instrumented executable at exe_output, runs the [pgo] train command
+    (by default the executable itself, with no arguments) from train_dir, and
+    rebuilds with the recorded profile. Returns True on success.
+    """
+    train = (config or {}).get("pgo", {}).get("train", [str(exe_output)])
+    if not isinstance(train, list) or not train or not all(isinstance(arg, str) for arg in train):
+        print('Error: [pgo] train must be a command as a list of strings, e.g. ["bin/app", "data/sample.csv"].')
+        return False
+    print("PGO 1/3: Building the instrumented executable...")
+    generate = dict(profile, pgo="generate")
+    built = build_objects(source_file, project_name, generate, [], jobs)
+    if not built or not link_executable(built[1], generate, exe_output):
+        return False
+    # The training run writes a .gcda next to each object file, and the second
+    # build, writing the same object paths, reads them back from there.
+    data_dir = built[1][0].obj_path(generate).parent
+    for stale in data_dir.glob("*.gcda"):
+        stale.unlink()  # Counts from an older build would be merged in otherwise
+
+    print(f"PGO 2/3: Training: {' '.join(train)}")
+    try:
+        result = subprocess.run(train, cwd=train_dir)
+    except OSError as e:
+        print(f"Error: Could not run the training command: {e}")
+        return False
+    if result.returncode != 0:
+        print(f"Error: The training command exited with code {result.returncode}.")
+        return False
+    if not any(data_dir.glob("*.gcda")):
+        print("Error: The training run wrote no profile data. Does [pgo] train run the instrumented executable?")
+        return False
+
+    print("PGO 3/3: Rebuilding with the recorded profile...")
+    use = dict(profile, pgo="use")
+    built = build_objects(source_file, project_name, use, [], jobs)
+    return bool(built) and link_executable(built[1], use, exe_output)
+
+def parse_arguments(args):
+    """Splits command arguments into positional arguments and options. Returns None on bad input."""
+    options = {"release": False, "profile": None, "pgo": False, "unity": False, "static": False, "jobs": os.cpu_count() or 1, "out": None}
+    positional = []
+    i = 0
+    while i < len(args):
+        arg = args[i]
+        if arg == "--release":
+            options["release"] = True
+        elif arg in ("--profile", "--profile=timers"):
+            options["profile"] = arg
+        elif arg == "--pgo":
+            options["pgo"] = True
+        elif arg in ("--unity", "--static"):
+            options[arg[2:]] = True
+        elif arg == "--jobs" or arg.startswith(("-j", "--jobs=")):
+            if arg in ("-j", "--jobs"):
+                i += 1
+                value = args[i] if i < len(args) else ""
+            else:
+                value = arg.split("=", 1)[1] if arg.startswith("--jobs=") else arg[2:]
+            if not value.isdigit() or int(value) < 1:
+                print(f"Error: Invalid job count for -j: '{value}'")
+                return None
+            options["jobs"] = int(value)
+        elif arg == "--out" or arg.startswith("--out="):
+            if arg == "--out":
+                i += 1
+                value = args[i] if i < len(args) else ""
+            else:
+                value = arg.split("=", 1)[1]
+            if not value:
+                print("Error: Missing path for --out.")
+                return None
+            options["out"] = value
+        elif arg.startswith("-"):
+            print(f"Warning: Unknown option '{arg}', ignoring.")
+        else:
+            positional.append(arg)
+        i += 1
+    return positional, options
+
 def find_config(start_path):
     """Searches upward from a path for a RedConfig.toml file."""
     current_path = start_path.resolve()
@@ -164,7 +567,102 @@ def find_config(start_path):
         current_path = current_path.parent
     return None
 
+def format_ns(ns):
+    """Formats a duration the way rl_bench.hpp's table does."""
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.2f} {unit}"
+    return f"{ns:.1f} ns"
+
+def run_bench_json(exe_path, cwd):
+    """Runs a benchmark executable with --json. Returns its results by name, or None if it failed."""
+    result = subprocess.run([str(exe_path), "--json"], cwd=cwd, capture_output=True, text=True)
+    if result.returncode != 0:
+        print(result.stdout)
+        print(result.stderr, file=sys.stderr)
+        return None
+    # Anything a kernel prints itself comes before the results object.
+    report = json.loads(result.stdout[result.stdout.index('{"benchmarks"'):])
+    return {entry["name"]: entry for entry in report["benchmarks"]}
+
+def run_bench_suite(positional, options, invocation_dir):
+    """Builds each suite kernel and its C++ reference with the bench profile, times both and compares them."""
+    name_filter = positional[0] if positional else ""
+    kernels = [path for path in sorted(BENCH_SUITE_DIR.glob("*.rl"))
+               if (BENCH_SUITE_DIR / "reference" / f"{path.stem}.cpp").exists() and name_filter in path.stem]
+    if not kernels:
+        print(f"No benchmark kernel matches '{name_filter}'.")
+        return False
+
+    profile = load_profile(None, True)
+    profile.update(name="bench", bench=True)
+    # The references include stdlib/rl_bench.hpp for the same harness, so both sides are timed identically.
+    reference_flags = [*compile_flags(profile), f"-I{PROJECT_ROOT}"]
+    results = []
+    for kernel in kernels:
+        print(f"\n== {kernel.stem}")
+        built = build_objects(kernel, kernel.stem, profile, [], options["jobs"])
+        if not built:
+            return False
+        cache_dir, modules = built
+        bench_exe = cache_dir / profile["name"] / kernel.stem
+        reference_exe = cache_dir / profile["name"] / f"{kernel.stem}-reference"
+        if not link_executable(modules, profile, bench_exe):
+            return False
+        reference_src = BENCH_SUITE_DIR / "reference" / f"{kernel.stem}.cpp"
+        print(f"Compiling reference {reference_src.name}...")
+        try:
+            subprocess.run(["g++", *reference_flags, str(reference_src), *link_flags(profile), "-o", str(reference_exe)], check=True)
+        except subprocess.CalledProcessError as e:
+            print(f"G++ compilation failed for {reference_src.name}: {e}")
+            return False
+
+        # Run in the cache directory, since the file I/O kernel writes a scratch file.
+        print("Running...")
+        redline_results = run_bench_json(bench_exe, cache_dir)
+        reference_results = run_bench_json(reference_exe, cache_dir)
+        if redline_results is None or reference_results is None:
+            print(f"Benchmark run failed for {kernel.stem}.")
+            return False
+        for name, redline in redline_results.items():
+            reference = reference_results.get(name)
+            if reference is None:
+                print(f"Warning: {reference_src.name} has no benchmark '{name}', skipping it.")
+                continue
+            # Throughput relative to the reference: above 1.0 the REDLINE version is faster.
+            ratio = reference["median_ns"] / redline["median_ns"] if redline["median_ns"] > 0 else 0.0
+            results.append({"kernel": kernel.stem, "name": name, "redline": redline, "reference": reference, "ratio": round(ratio, 4)})
+
+    width = max([9] + [len(r["name"]) for r in results])
+    print(f"\n{'Benchmark':<{width}} {'redline':>12} {'C++':>12} {'ratio':>8}")
+    for r in results:
+        print(f"{r['name']:<{width}} {format_ns(r['redline']['median_ns']):>12} {format_ns(r['reference']['median_ns']):>12} {r['ratio']:>8.2f}")
+
+    compiler_version = subprocess.run(["g++", "--version"], capture_output=True, text=True).stdout.splitlines()
+    report = {
+        "timestamp": datetime.now(timezone.utc).isoformat(timespec="seconds"),
+        "redline_version": VERSION,
+        "compiler": compiler_version[0] if compiler_version else "g++",
+        "machine": platform.machine(),
+        "cpus": os.cpu_count(),
+        "compile_flags": compile_flags(profile),
+        "link_flags": link_flags(profile),
+        "benchmarks": results,
+    }
+    out_path = Path(options["out"]) if options["out"] else BUILD_DIR / "bench-suite.json"
+    if not out_path.is_absolute():
+        out_path = invocation_dir / out_path
+    out_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(out_path, "w") as f:
+        json.dump(report, f, indent=2)
+        f.write("\n")
+    print(f"\nResults written to: {out_path}")
+    return True
+
 def main():
+    # Remember where we were invoked from before moving to the project root,
+    # so that relative file arguments and RedConfig.toml lookups still work.
+    invocation_dir = Path.cwd()
     # Ensure all paths are relative to the project root, even if called from elsewhere
     os.chdir(PROJECT_ROOT)
 
@@ -173,12 +671,24 @@ def main():
         return
 
     command = sys.argv[1]
+    parsed = parse_arguments(sys.argv[2:])
+    if parsed is None:
+        sys.exit(1)
+    positional, options = parsed
 
     if command == "init":
         if not init_core():
             sys.exit(1)
         return
 
+    if command == "clean":
+        if BUILD_DIR.exists():
+            shutil.rmtree(BUILD_DIR)
+            print(f"Removed build cache: {BUILD_DIR}")
+        else:
+            print("Build cache is already empty.")
+        return
+
     if not CORE_BIN.exists():
         print("REDLINE Core binary not found. Running 'init' first...")
         if not init_core():
@@ -186,21 +696,27 @@ def main():
             sys.exit(1)
         print("Core initialized. Continuing...")
 
+    if command == "bench-suite":
+        if not run_bench_suite(positional, options, invocation_dir):
+            sys.exit(1)
+        return
+
     source_file = None
     project_name = None
     output_dir = None
+    config = None
     
     # Determine build mode (file vs. config)
-    if command == "build" and len(sys.argv) < 3:
+    if command == "build" and not positional:
         # Config-based build from current directory
-        config_path = Path.cwd() / "RedConfig.toml"
+        config_path = invocation_dir / "RedConfig.toml"
         if not config_path.exists():
             print("Error: No input file specified and no RedConfig.toml found in current directory.")
             print_usage()
             return
     else:
         # File-based build, potentially with config lookup
-        file_arg = sys.argv[2] if len(sys.argv) >= 3 else None
+        file_arg = positional[0] if positional else None
         if not file_arg:
             print(f"Error: Missing file path for '{command}' command.")
             print_usage()
@@ -208,7 +724,7 @@ def main():
         
         source_file = Path(file_arg)
         if not source_file.is_absolute():
-            source_file = Path.cwd() / source_file
+            source_file = invocation_dir / source_file
         
         if not source_file.exists():
             print(f"Error: File not found: {source_file}")
@@ -241,58 +757,75 @@ def main():
         project_name = source_file.stem
         output_dir = source_file.parent
 
-    compiler = Compiler(CORE_BIN)
-    BUILD_DIR.mkdir(exist_ok=True)
-
-    try:
-        print(f"Starting build for entry point: {source_file.name}")
-        main_module = compiler.compile_module_recursive(source_file)
-
-        if not main_module:
-            print("Build failed during module analysis.")
-            return
+    profile = load_profile(config, options["release"] or command == "bench")
+    if command == "bench":
+        # Same optimizations as release, but main() runs the @bench functions;
+        # built into its own object directory so it doesn't evict the release objects.
+        profile.update(name="bench", bench=True)
+    elif options["profile"]:
+        # Release optimizations, so the profile shows the real hot spots, plus
+        # what perf and gdb need to map them back to functions and .rl lines.
+        profile = load_profile(config, True)
+        profile.update(name="profile", debug_info=True, strip=False, frame_pointers=True)
+    elif options["pgo"]:
+        # Release optimizations, in an object directory of its own: both PGO
+        # builds write there, and the release objects are left alone.
+        profile = load_profile(config, True)
+        profile.update(name="pgo")
+
+    if command == "lib" and profile["lto"]:
+        # LTO objects normally hold only GCC's intermediate code, which a program
+        # linked without -flto can't use. Library objects carry both, in their own directory.
+        profile.update(name=f"{profile['name']}-lib", fat_lto=True)
+
+    # Like the other profile keys, these can also be set per profile in RedConfig.toml.
+    for key in ("unity", "static"):
+        if options[key]:
+            profile[key] = True
+
+    if options["pgo"]:
+        if command != "build" or options["profile"]:
+            print("Error: --pgo only works with 'build', and not together with --profile.")
+            sys.exit(1)
+        print(f"Starting PGO build for entry point: {source_file.name}")
+        exe_output = output_dir / project_name
+        train_dir = config_path.parent if config_path else invocation_dir
+        if not build_with_pgo(source_file, project_name, profile, config, train_dir, exe_output, options["jobs"]):
+            print("PGO build failed.")
+            sys.exit(1)
+        print(f"Build successful. Executable created at: {exe_output}")
+        return
 
-        all_modules = list(compiler.modules.values())
-        
-        print("Generating C++ code...")
-        for module in all_modules:
-            if not compiler.generate_code(module, "hpp") or not compiler.generate_code(module, "cpp"):
-                return
+    # Profiling builds generate different C++, so they get a cache directory of their own.
+    core_args = [options["profile"]] if options["profile"] and command != "bench" else []
+    print(f"Starting build for entry point: {source_file.name}")
+    built = build_objects(source_file, project_name, profile, core_args, options["jobs"], codegen_only=command == "parse")
+    if not built:
+        return
+    cache_dir, all_modules = built
 
-        if command == "parse":
-            print(f"C++ output generated in: {BUILD_DIR}")
-            return
+    if command == "parse":
+        print(f"C++ output generated in: {cache_dir}")
+        return
 
-        if command == "lib":
-            print("Compiling object files...")
-            for module in all_modules:
-                print(f"  -> Compiling {module.name}.o")
-                try:
-                    subprocess.run(
-                        ["g++", "-std=c++17", "-c", str(module.cpp_path), "-o", str(module.obj_path), f"-I{BUILD_DIR}", f"-I{PROJECT_ROOT}"],
-                        check=True
-                    )
-                except subprocess.CalledProcessError as e:
-                    print(f"Compilation failed for {module.name}: {e}")
-                    return
-            print(f"Library object files generated in: {BUILD_DIR}")
-            return
+    if command == "lib":
+        print(f"Library object files generated in: {all_modules[0].obj_path(profile).parent}")
+        return
 
-        if command == "build":
-            exe_output = output_dir / project_name
-            cpp_files = [m.cpp_path for m in all_modules]
+    if command == "build":
+        exe_output = output_dir / project_name
+        print("Linking...")
+        if link_executable(all_modules, profile, exe_output):
+            print(f"Build successful. Executable created at: {exe_output}")
 
-            print("Compiling and linking...")
-            try:
-                cmd = ["g++", "-std=c++17", *cpp_files, "-o", str(exe_output), f"-I{BUILD_DIR}", f"-I{PROJECT_ROOT}"]
-                subprocess.run(cmd, check=True)
-                print(f"Build successful. Executable created at: {exe_output}")
-            except subprocess.CalledProcessError as e:
-                print(f"G++ compilation failed: {e}")
-    finally:
-        if BUILD_DIR.exists():
-            shutil.rmtree(BUILD_DIR)
-            print("Temporary build directory cleaned up.")
+    if command == "bench":
+        bench_exe = cache_dir / profile["name"] / project_name
+        if not link_executable(all_modules, profile, bench_exe):
+            sys.exit(1)
+        print("Running benchmarks...\n")
+        result = subprocess.run([str(bench_exe), *positional[1:]], cwd=invocation_dir)
+        if result.returncode != 0:
+            sys.exit(result.returncode)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,185 @@
+#ifndef RL_ARENA_HPP
+#define RL_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace rl {
+
+    namespace detail {
+        // The arena `new` currently allocates from on this thread, or null for the heap.
+        inline std::pmr::memory_resource*& current_arena() {
+            thread_local std::pmr::memory_resource* arena = nullptr;
+            return arena;
+        }
+
+        // Blocks released by closed arenas, kept per thread so the next arena
+        // (typically the next loop iteration) doesn't go back to malloc/mmap and
+        // fault in fresh pages.
+        class BlockCache {
+        public:
+            struct Block {
+                char* data;
+                std::size_t size;
+            };
+
+            ~BlockCache() {
+                for (const Block& block : blocks_) {
+                    ::operator delete(block.data);
+                }
+            }
+
+            Block take(std::size_t min_size) {
+                for (std::size_t i = 0; i < blocks_.size(); ++i) {
+                    if (blocks_[i].size >= min_size) {
+                        Block block = blocks_[i];
+                        blocks_[i] = blocks_.back();
+                        blocks_.pop_back();
+                        cached_bytes_ -= block.size;
+                        return block;
+                    }
+                }
+                return Block{ static_cast<char*>(::operator new(min_size)), min_size };
+            }
+
+            void give_back(const Block& block) {
+                if (cached_bytes_ + block.size > max_cached_bytes) {
+                    ::operator delete(block.data);
+                    return;
+                }
+                blocks_.push_back(block);
+                cached_bytes_ += block.size;
+            }
+
+        private:
+            static constexpr std::size_t max_cached_bytes = 16 * 1024 * 1024;
+            std::vector<Block> blocks_;
+            std::size_t cached_bytes_ = 0;
+        };
+
+        inline BlockCache& block_cache() {
+            thread_local BlockCache cache;
+            return cache;
+        }
+
+        // Identifies the current thread by the address of a thread-local.
+        inline const void* thread_tag() {
+            thread_local char tag;
+            return &tag;
+        }
+
+        // A bump allocator that also counts live allocations, so the arena can
+        // tell whether anything it handed out is still in use when it closes.
+        class ArenaResource : public std::pmr::memory_resource {
+        public:
+            explicit ArenaResource(std::size_t initial_size)
+                : next_size_(initial_size < 256 ? 256 : initial_size), owner_(thread_tag()) {}
+
+            std::size_t live() const {
+                return allocated_ - released_ - released_elsewhere_.load(std::memory_order_acquire);
+            }
+
+            // Hands every block back to this thread's cache. Only valid once nothing is live.
+            void recycle() {
+                for (const BlockCache::Block& block : blocks_) {
+                    block_cache().give_back(block);
+                }
+                blocks_.clear();
+            }
+
+        private:
+            static constexpr std::size_t max_block_size = 4 * 1024 * 1024;
+
+            std::vector<BlockCache::Block> blocks_;
+            char* cursor_ = nullptr;
+            char* limit_ = nullptr;
+            std::size_t next_size_;
+            const void* owner_;
+            // Allocation only happens on the owning thread; objects may be
+            // released anywhere (shared ownership), so only those are atomic.
+            std::size_t allocated_ = 0;
+            std::size_t released_ = 0;
+            std::atomic<std::size_t> released_elsewhere_{0};
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                std::size_t space = static_cast<std::size_t>(limit_ - cursor_);
+                void* p = cursor_;
+                if (!cursor_ || !std::align(alignment, bytes, p, space)) {
+                    grow(bytes + alignment);
+                    p = cursor_;
+                    space = static_cast<std::size_t>(limit_ - cursor_);
+                    std::align(alignment, bytes, p, space);
+                }
+                cursor_ = static_cast<char*>(p) + bytes;
+                ++allocated_;
+                return p;
+            }
+
+            // Freeing a single object is a no-op; the memory comes back all at once.
+            void do_deallocate(void*, std::size_t, std::size_t) override {
+                if (thread_tag() == owner_) {
+                    ++released_;
+                } else {
+                    released_elsewhere_.fetch_add(1, std::memory_order_release);
+                }
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            void grow(std::size_t min_size) {
+                BlockCache::Block block = block_cache().take(min_size > next_size_ ? min_size : next_size_);
+                blocks_.push_back(block);
+                cursor_ = block.data;
+                limit_ = block.data + block.size;
+                if (next_size_ < max_block_size) {
+                    next_size_ *= 2;
+                }
+            }
+        };
+    }
+
+    // A region for short-lived objects, opened by `with arena:`. While it's
+    // active, `new` on a class bump-allocates from one growing buffer instead
+    // of calling malloc per object, and everything is released in one go when
+    // the block ends.
+    //
+    // If an object escapes the block (returned, stored in an outer list...),
+    // the arena can't be freed without leaving it dangling, so its memory is
+    // kept alive instead. Debug builds print a warning when that happens.
+    class Arena {
+    public:
+        explicit Arena(std::size_t initial_size = 64 * 1024)
+            : resource_(new detail::ArenaResource(initial_size)), previous_(detail::current_arena()) {
+            detail::current_arena() = resource_.get();
+        }
+
+        ~Arena() {
+            detail::current_arena() = previous_;
+            std::size_t live = resource_->live();
+            if (live != 0) {
+#ifndef NDEBUG
+                std::fprintf(stderr, "REDLINE warning: %zu object(s) outlived their arena; keeping its memory alive.\n", live);
+#endif
+                resource_.release(); // Deliberately leaked: the survivors still point into it.
+            } else {
+                resource_->recycle();
+            }
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+    private:
+        std::unique_ptr<detail::ArenaResource> resource_;
+        std::pmr::memory_resource* previous_;
+    };
+
+} // namespace rl
+
+#endif // RL_ARENA_HPP
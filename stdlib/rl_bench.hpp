@@ -0,0 +1,171 @@
+#ifndef RL_BENCH_HPP
+#define RL_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rl_io.hpp"
+
+namespace rl {
+
+    // Makes the compiler treat `value` as used, so a benchmarked computation
+    // whose result is otherwise thrown away can't be optimized out.
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // One `@bench` function, as registered by the generated main().
+    struct BenchCase {
+        std::string name;
+        std::function<void()> run;
+    };
+
+    template<typename F>
+    inline BenchCase bench_case(const char* name, F function) {
+        return BenchCase{ name, [function] {
+            if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
+                function();
+            } else {
+                do_not_optimize(function());
+            }
+        } };
+    }
+
+    namespace detail {
+        using bench_clock = std::chrono::steady_clock;
+
+        struct BenchResult {
+            double median_ns;
+            double p99_ns;
+            double min_ns;
+            long long calls;
+        };
+
+        inline double elapsed_ns(bench_clock::time_point start) {
+            return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+        }
+
+        // Warms up for ~50 ms, then times batches of calls long enough (~1 ms) for
+        // the clock to resolve, for about a second. Each batch gives one sample:
+        // the average time per call within it.
+        inline BenchResult measure(const BenchCase& bench) {
+            constexpr double warmup_ns = 50e6, batch_ns = 1e6, budget_ns = 1e9;
+            constexpr std::size_t min_samples = 10, max_samples = 1000;
+
+            long long warmup_calls = 0;
+            bench_clock::time_point start = bench_clock::now();
+            do {
+                bench.run();
+                ++warmup_calls;
+            } while (elapsed_ns(start) < warmup_ns);
+            double per_call = elapsed_ns(start) / static_cast<double>(warmup_calls);
+            long long batch = std::max(1LL, static_cast<long long>(batch_ns / std::max(per_call, 1.0)));
+
+            std::vector<double> samples;
+            double total = 0;
+            while (samples.size() < min_samples || (total < budget_ns && samples.size() < max_samples)) {
+                start = bench_clock::now();
+                for (long long i = 0; i < batch; ++i) {
+                    bench.run();
+                }
+                double sample = elapsed_ns(start);
+                total += sample;
+                samples.push_back(sample / static_cast<double>(batch));
+            }
+
+            std::sort(samples.begin(), samples.end());
+            std::size_t p99 = (samples.size() * 99 + 99) / 100 - 1;
+            return BenchResult{ samples[samples.size() / 2], samples[p99], samples.front(), batch * static_cast<long long>(samples.size()) };
+        }
+
+        inline std::string format_ns(double ns) {
+            char buffer[32];
+            if (ns < 1e3) std::snprintf(buffer, sizeof buffer, "%.1f ns", ns);
+            else if (ns < 1e6) std::snprintf(buffer, sizeof buffer, "%.2f us", ns / 1e3);
+            else if (ns < 1e9) std::snprintf(buffer, sizeof buffer, "%.2f ms", ns / 1e6);
+            else std::snprintf(buffer, sizeof buffer, "%.2f s", ns / 1e9);
+            return buffer;
+        }
+    }
+
+    // What the generated main() runs in a `redline bench` build. The first
+    // command-line argument, if any, only runs benchmarks whose name contains it.
+    // With `--json`, the results are printed as one JSON object instead of a
+    // table, for `redline bench-suite` and other tools.
+    inline int run_benchmarks(const std::vector<BenchCase>& benches, const std::vector<std::string>& args) {
+        if (benches.empty()) {
+            print("No @bench functions in this program.");
+            return 1;
+        }
+        std::string filter;
+        bool json = false;
+        for (std::size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--json") {
+                json = true;
+            } else if (filter.empty()) {
+                filter = args[i];
+            }
+        }
+        std::size_t width = 9;
+        for (const BenchCase& bench : benches) {
+            width = std::max(width, bench.name.size());
+        }
+
+        char line[256];
+        if (json) {
+            print("{\"benchmarks\": [");
+        } else {
+            std::snprintf(line, sizeof line, "%-*s %12s %12s %12s %12s", static_cast<int>(width), "Benchmark", "median", "p99", "min", "calls");
+            print(line);
+        }
+        int ran = 0;
+        std::string pending; // The last JSON entry, held back for its separator.
+        for (const BenchCase& bench : benches) {
+            if (bench.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            detail::BenchResult result = detail::measure(bench);
+            if (json) {
+                // Benchmark names are REDLINE identifiers, so they need no escaping.
+                std::snprintf(line, sizeof line, "  {\"name\": \"%s\", \"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, \"calls\": %lld}",
+                    bench.name.c_str(), result.median_ns, result.p99_ns, result.min_ns, result.calls);
+                if (!pending.empty()) {
+                    print(pending + ",");
+                }
+                pending = line;
+            } else {
+                std::snprintf(line, sizeof line, "%-*s %12s %12s %12s %12lld", static_cast<int>(width), bench.name.c_str(),
+                    detail::format_ns(result.median_ns).c_str(), detail::format_ns(result.p99_ns).c_str(),
+                    detail::format_ns(result.min_ns).c_str(), result.calls);
+                print(line);
+                flush();
+            }
+            ++ran;
+        }
+        if (json) {
+            if (!pending.empty()) {
+                print(pending);
+            }
+            print("]}");
+        }
+        if (ran == 0) {
+            print("No benchmark matches '" + filter + "'.");
+            return 1;
+        }
+        return 0;
+    }
+
+} // namespace rl
+
+#endif // RL_BENCH_HPP
@@ -0,0 +1,290 @@
+#ifndef RL_DICT_HPP
+#define RL_DICT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rl {
+
+    // The hash map behind REDLINE's dict[K, V].
+    //
+    // Entries live densely in one vector (so iteration is a linear scan and
+    // follows insertion order until something is erased), and lookups go through
+    // an open-addressing index of 32-bit slots with linear probing. No per-entry
+    // heap nodes, no pointer chasing: one hash, a couple of adjacent slot reads.
+    // Like std::vector, inserting may invalidate references to existing values.
+    template<typename K, typename V, typename Hash = std::hash<K>>
+    class dict {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        dict() = default;
+
+        dict(std::initializer_list<value_type> init) {
+            reserve(init.size());
+            for (const auto& entry : init) {
+                (*this)[entry.first] = entry.second;
+            }
+        }
+
+        // Returns the value for a key. Throws if the key is missing, like std::map::at.
+        V& at(const K& key) {
+            std::size_t index = find_index(key);
+            if (index == npos) {
+                throw std::out_of_range("Key not found in dict");
+            }
+            return entries_[index].second;
+        }
+
+        const V& at(const K& key) const {
+            std::size_t index = find_index(key);
+            if (index == npos) {
+                throw std::out_of_range("Key not found in dict");
+            }
+            return entries_[index].second;
+        }
+
+        // Returns the value for a key, inserting a default-constructed one if it's missing.
+        V& operator[](const K& key) {
+            std::size_t hash = mix(Hash{}(key));
+            std::size_t index = find_index(key, hash);
+            if (index != npos) {
+                return entries_[index].second;
+            }
+            return insert_new(key, V{}, hash).second;
+        }
+
+        // Inserts or overwrites a key. Returns true if the key was new.
+        bool insert_or_assign(const K& key, V value) {
+            std::size_t hash = mix(Hash{}(key));
+            std::size_t index = find_index(key, hash);
+            if (index != npos) {
+                entries_[index].second = std::move(value);
+                return false;
+            }
+            insert_new(key, std::move(value), hash);
+            return true;
+        }
+
+        bool contains(const K& key) const { return find_index(key) != npos; }
+        std::size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+
+        iterator find(const K& key) {
+            std::size_t index = find_index(key);
+            return index == npos ? entries_.end() : entries_.begin() + index;
+        }
+
+        const_iterator find(const K& key) const {
+            std::size_t index = find_index(key);
+            return index == npos ? entries_.end() : entries_.begin() + index;
+        }
+
+        // Removes a key. The last entry is moved into its place, so erasing is O(1)
+        // but doesn't preserve insertion order. Returns the number of entries removed.
+        std::size_t erase(const K& key) {
+            std::size_t hash = mix(Hash{}(key));
+            std::size_t slot = find_slot(key, hash);
+            if (slot == npos) {
+                return 0;
+            }
+            std::size_t index = slots_[slot] - 1;
+            remove_slot(slot);
+
+            std::size_t last = entries_.size() - 1;
+            if (index != last) {
+                // Repoint the slot of the last entry at the hole it's about to fill.
+                std::size_t last_slot = slot_of_entry(last);
+                slots_[last_slot] = static_cast<std::uint32_t>(index + 1);
+                entries_[index] = std::move(entries_[last]);
+                hashes_[index] = hashes_[last];
+            }
+            entries_.pop_back();
+            hashes_.pop_back();
+            return 1;
+        }
+
+        std::size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+
+        void clear() {
+            entries_.clear();
+            hashes_.clear();
+            std::fill(slots_.begin(), slots_.end(), 0);
+        }
+
+        // Makes room for at least n entries without rehashing.
+        void reserve(std::size_t n) {
+            entries_.reserve(n);
+            hashes_.reserve(n);
+            std::size_t needed = 8;
+            while (needed * 3 < n * 4) {
+                needed *= 2;
+            }
+            if (needed > slots_.size()) {
+                rehash(needed);
+            }
+        }
+
+        iterator begin() { return entries_.begin(); }
+        iterator end() { return entries_.end(); }
+        const_iterator begin() const { return entries_.begin(); }
+        const_iterator end() const { return entries_.end(); }
+
+        bool operator==(const dict& other) const {
+            if (size() != other.size()) {
+                return false;
+            }
+            for (const auto& entry : entries_) {
+                auto it = other.find(entry.first);
+                if (it == other.end() || !(it->second == entry.second)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const dict& other) const { return !(*this == other); }
+
+    private:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        std::vector<value_type> entries_;
+        std::vector<std::size_t> hashes_;   // Mixed hash of each entry, parallel to entries_.
+        std::vector<std::uint32_t> slots_;  // Entry index + 1, or 0 for an empty slot. Size is a power of two.
+
+        // std::hash is the identity for integers on most platforms, which would
+        // cluster badly under power-of-two masking, so scramble the bits first.
+        static std::size_t mix(std::size_t h) {
+            std::uint64_t x = static_cast<std::uint64_t>(h);
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+
+        std::size_t mask() const { return slots_.size() - 1; }
+
+        std::size_t find_slot(const K& key, std::size_t hash) const {
+            if (slots_.empty()) {
+                return npos;
+            }
+            for (std::size_t slot = hash & mask(); slots_[slot] != 0; slot = (slot + 1) & mask()) {
+                std::size_t index = slots_[slot] - 1;
+                if (hashes_[index] == hash && entries_[index].first == key) {
+                    return slot;
+                }
+            }
+            return npos;
+        }
+
+        std::size_t find_index(const K& key, std::size_t hash) const {
+            std::size_t slot = find_slot(key, hash);
+            return slot == npos ? npos : slots_[slot] - 1;
+        }
+
+        std::size_t find_index(const K& key) const {
+            return find_index(key, mix(Hash{}(key)));
+        }
+
+        std::size_t slot_of_entry(std::size_t index) const {
+            std::size_t slot = hashes_[index] & mask();
+            while (slots_[slot] != index + 1) {
+                slot = (slot + 1) & mask();
+            }
+            return slot;
+        }
+
+        value_type& insert_new(const K& key, V value, std::size_t hash) {
+            // Keep the load factor at or below 3/4 so probe sequences stay short.
+            if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+                rehash(slots_.empty() ? 8 : slots_.size() * 2);
+            }
+            std::size_t slot = hash & mask();
+            while (slots_[slot] != 0) {
+                slot = (slot + 1) & mask();
+            }
+            entries_.emplace_back(key, std::move(value));
+            hashes_.push_back(hash);
+            slots_[slot] = static_cast<std::uint32_t>(entries_.size());
+            return entries_.back();
+        }
+
+        // Backward-shift deletion: pull later members of the probe run into the
+        // gap so lookups never need tombstones.
+        void remove_slot(std::size_t hole) {
+            std::size_t slot = (hole + 1) & mask();
+            while (slots_[slot] != 0) {
+                std::size_t home = hashes_[slots_[slot] - 1] & mask();
+                // Move the entry back if its home isn't in the cyclic range (hole, slot].
+                bool movable = (slot > hole) ? (home <= hole || home > slot) : (home <= hole && home > slot);
+                if (movable) {
+                    slots_[hole] = slots_[slot];
+                    hole = slot;
+                }
+                slot = (slot + 1) & mask();
+            }
+            slots_[hole] = 0;
+        }
+
+        void rehash(std::size_t new_size) {
+            slots_.assign(new_size, 0);
+            for (std::size_t index = 0; index < entries_.size(); ++index) {
+                std::size_t slot = hashes_[index] & mask();
+                while (slots_[slot] != 0) {
+                    slot = (slot + 1) & mask();
+                }
+                slots_[slot] = static_cast<std::uint32_t>(index + 1);
+            }
+        }
+    };
+
+    namespace detail {
+        // A lookup key as the map's own key type: a str_view becomes a string.
+        template<typename K, typename Key>
+        decltype(auto) as_key(const Key& key) {
+            if constexpr (std::is_same_v<K, Key>) {
+                return (key);
+            } else {
+                return K(key);
+            }
+        }
+    }
+
+    // `d[key] = value`: unlike reading d[key], a missing key is added. The value
+    // is taken by value, so `d[a] = d[b]` copies d[b] before an insert can move it.
+    template<typename K, typename V, typename Hash, typename Key>
+    void set_entry(dict<K, V, Hash>& d, const Key& key, typename dict<K, V, Hash>::mapped_type value) {
+        d.insert_or_assign(detail::as_key<K>(key), std::move(value));
+    }
+
+    template<typename K, typename V, typename Compare, typename Alloc, typename Key>
+    void set_entry(std::map<K, V, Compare, Alloc>& m, const Key& key, typename std::map<K, V, Compare, Alloc>::mapped_type value) {
+        m.insert_or_assign(detail::as_key<K>(key), std::move(value));
+    }
+
+    // True if the dict has the key: `if contains(counts, word):`.
+    template<typename K, typename V, typename Hash, typename Key>
+    bool contains(const dict<K, V, Hash>& d, const Key& key) {
+        return d.contains(detail::as_key<K>(key));
+    }
+
+    template<typename K, typename V, typename Compare, typename Alloc, typename Key>
+    bool contains(const std::map<K, V, Compare, Alloc>& m, const Key& key) {
+        return m.count(detail::as_key<K>(key)) != 0;
+    }
+
+} // namespace rl
+
+#endif // RL_DICT_HPP
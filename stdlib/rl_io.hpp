@@ -2,43 +2,227 @@
 #ifndef RL_IO_H
 #define RL_IO_H
 
-#include <iostream>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace rl {
+    namespace detail {
+        // A big in-process buffer in front of stdout. print() appends to it and
+        // only hits the OS when it fills up, on flush(), before input(), and at exit.
+        // When stdout is a terminal it switches to line buffering so interactive
+        // programs still see every line as it's printed.
+        // Threads share it: every print() holds lock() for the whole line, so
+        // lines from different threads are never lost or mixed together.
+        class OutputBuffer {
+        public:
+            OutputBuffer() : size_(0) {
+#ifdef _WIN32
+                line_buffered_ = _isatty(_fileno(stdout)) != 0;
+#else
+                line_buffered_ = isatty(fileno(stdout)) != 0;
+#endif
+                // Uncaught exceptions skip static destructors; don't lose the output with them.
+                previous_terminate_ = std::set_terminate(on_terminate);
+            }
+
+            ~OutputBuffer() { flush(); }
+
+            std::unique_lock<std::mutex> lock() { return std::unique_lock<std::mutex>(mutex_); }
+
+            // write(), put(), end_line() and flush_locked() need lock() held.
+            void write(const char* data, std::size_t len) {
+                if (len > sizeof(data_) - size_) {
+                    flush_locked();
+                    if (len > sizeof(data_)) {
+                        std::fwrite(data, 1, len, stdout);
+                        std::fflush(stdout);
+                        return;
+                    }
+                }
+                std::memcpy(data_ + size_, data, len);
+                size_ += len;
+            }
+
+            void put(char c) {
+                if (size_ == sizeof(data_)) {
+                    flush_locked();
+                }
+                data_[size_++] = c;
+            }
+
+            void end_line() {
+                put('\n');
+                if (line_buffered_) {
+                    flush_locked();
+                }
+            }
+
+            void flush() {
+                std::lock_guard<std::mutex> guard(mutex_);
+                flush_locked();
+            }
+
+            void flush_locked() {
+                if (size_ > 0) {
+                    std::fwrite(data_, 1, size_, stdout);
+                    size_ = 0;
+                }
+                std::fflush(stdout);
+            }
+
+            void set_line_buffered(bool enabled) {
+                std::lock_guard<std::mutex> guard(mutex_);
+                line_buffered_ = enabled;
+            }
+
+        private:
+            char data_[1 << 16];
+            std::size_t size_;
+            bool line_buffered_;
+            std::mutex mutex_;
+
+            static inline std::terminate_handler previous_terminate_ = nullptr;
+            static void on_terminate();
+        };
+
+        inline OutputBuffer& stdout_buffer() {
+            static OutputBuffer buffer;
+            return buffer;
+        }
+
+        inline void OutputBuffer::on_terminate() {
+            stdout_buffer().flush();
+            if (previous_terminate_) {
+                previous_terminate_();
+            }
+            std::abort();
+        }
+
+        // Appends a value's text to the buffer without building a temporary string.
+        inline void write_value(const std::string& s) { stdout_buffer().write(s.data(), s.size()); }
+        inline void write_value(const char* s) { stdout_buffer().write(s, std::strlen(s)); }
+        inline void write_value(std::string_view s) { stdout_buffer().write(s.data(), s.size()); }
+        inline void write_value(bool val) { write_value(val ? "true" : "false"); }
+
+        inline void write_value(int val) {
+            char buf[16];
+            auto result = std::to_chars(buf, buf + sizeof(buf), val);
+            stdout_buffer().write(buf, result.ptr - buf);
+        }
+
+        inline void write_value(double val) {
+            // Matches rl::to_string(double): the shortest text that reads back the same.
+            char buf[32];
+            auto result = std::to_chars(buf, buf + sizeof(buf), val);
+            stdout_buffer().write(buf, result.ptr - buf);
+        }
+    }
+
     // Overload for printing std::string
     inline void print(const std::string& msg) {
-        std::cout << msg << std::endl;
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(msg);
+        detail::stdout_buffer().end_line();
     }
 
     // Overload for printing string literals to prevent implicit bool conversion
     inline void print(const char* msg) {
-        std::cout << msg << std::endl;
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(msg);
+        detail::stdout_buffer().end_line();
+    }
+
+    // Overload for printing string views
+    inline void print(std::string_view msg) {
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(msg);
+        detail::stdout_buffer().end_line();
     }
 
     // Overload for printing integers
     inline void print(int val) {
-        std::cout << val << std::endl;
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(val);
+        detail::stdout_buffer().end_line();
     }
 
     // Overload for printing floating-point numbers
     inline void print(double val) {
-        std::cout << val << std::endl;
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(val);
+        detail::stdout_buffer().end_line();
     }
 
     // Overload for printing booleans
     inline void print(bool val) {
-        std::cout << (val ? "true" : "false") << std::endl;
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(val);
+        detail::stdout_buffer().end_line();
+    }
+
+    // Prints an empty line.
+    inline void print() {
+        auto lock = detail::stdout_buffer().lock();
+        detail::stdout_buffer().end_line();
+    }
+
+    // Prints several values separated by spaces, e.g. print("x =", x).
+    // Each value is written straight into the buffer; no strings are concatenated.
+    template<typename First, typename Second, typename... Rest>
+    inline void print(const First& first, const Second& second, const Rest&... rest) {
+        auto lock = detail::stdout_buffer().lock();
+        detail::write_value(first);
+        detail::stdout_buffer().put(' ');
+        detail::write_value(second);
+        ((detail::stdout_buffer().put(' '), detail::write_value(rest)), ...);
+        detail::stdout_buffer().end_line();
+    }
+
+    // Writes any buffered output to the terminal/file right now.
+    inline void flush() {
+        detail::stdout_buffer().flush();
+    }
+
+    // Prints a line and flushes it immediately, for progress messages and the like.
+    template<typename... Args>
+    inline void print_unbuffered(const Args&... args) {
+        print(args...);
+        flush();
+    }
+
+    // Forces line buffering on or off. By default it's on when stdout is a terminal.
+    inline void set_line_buffered(bool enabled) {
+        detail::stdout_buffer().set_line_buffered(enabled);
     }
 
     // Function to read a line of input from the user
     inline std::string input(const std::string& prompt = "") {
-        if (!prompt.empty()) {
-            std::cout << prompt;
+        {
+            auto lock = detail::stdout_buffer().lock();
+            if (!prompt.empty()) {
+                detail::write_value(prompt);
+            }
+            // Whatever was printed so far (including the prompt) must be visible before we block.
+            detail::stdout_buffer().flush_locked();
         }
+        // Read with C stdio like the rest of rl_io, so programs don't depend on iostream.
         std::string line;
-        std::getline(std::cin, line);
+        for (int c = std::getc(stdin); c != EOF && c != '\n'; c = std::getc(stdin)) {
+            line.push_back(static_cast<char>(c));
+        }
         return line;
     }
 }
@@ -2,6 +2,19 @@
 #define RL_MATH_HPP
 
 #include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RL_SIMD_AVX2 1
+#include <immintrin.h>
+#define RL_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__aarch64__)
+#define RL_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace rl {
     // Basic math functions
@@ -25,6 +38,462 @@ namespace rl {
     // Constants
     constexpr double PI = 3.14159265358979323846;
     constexpr double E = 2.71828182845904523536;
+
+    // --- Bulk operations on list[float] / list[int] ---
+    //
+    // Each has an AVX2 version picked at run time on x86 (so one binary runs
+    // on any x86-64 machine), a NEON version on 64-bit ARM, and a plain loop
+    // everywhere else.
+
+    namespace detail {
+#if defined(RL_SIMD_AVX2)
+        inline bool has_avx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+#endif
+
+        // Float sums keep 8 running totals (element i goes into total i % 8)
+        // and combine them the same way on every path, so sum() and dot() give
+        // identical results whichever version runs.
+        inline double fold_lanes(const double* t) {
+            return ((t[0] + t[4]) + (t[2] + t[6])) + ((t[1] + t[5]) + (t[3] + t[7]));
+        }
+
+#if defined(RL_SIMD_AVX2)
+        RL_TARGET_AVX2 inline double sum_f64_avx2(const double* p, std::size_t n) {
+            std::size_t i = 0;
+            __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+            for (; i + 8 <= n; i += 8) {
+                lo = _mm256_add_pd(lo, _mm256_loadu_pd(p + i));
+                hi = _mm256_add_pd(hi, _mm256_loadu_pd(p + i + 4));
+            }
+            alignas(32) double t[8];
+            _mm256_store_pd(t, lo);
+            _mm256_store_pd(t + 4, hi);
+            double total = fold_lanes(t);
+            for (; i < n; ++i) total += p[i];
+            return total;
+        }
+
+        // Multiply then add (no FMA), to round exactly like the other paths.
+        RL_TARGET_AVX2 inline double dot_f64_avx2(const double* a, const double* b, std::size_t n) {
+            std::size_t i = 0;
+            __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+            for (; i + 8 <= n; i += 8) {
+                lo = _mm256_add_pd(lo, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+                hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+            }
+            alignas(32) double t[8];
+            _mm256_store_pd(t, lo);
+            _mm256_store_pd(t + 4, hi);
+            double total = fold_lanes(t);
+            for (; i < n; ++i) total += a[i] * b[i];
+            return total;
+        }
+
+        RL_TARGET_AVX2 inline void sqrt_f64_avx2(double* out, const double* p, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_loadu_pd(p + i)));
+            }
+            for (; i < n; ++i) out[i] = std::sqrt(p[i]);
+        }
+#endif
+
+        inline double sum_f64(const double* p, std::size_t n) {
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                return sum_f64_avx2(p, n);
+            }
+#endif
+            std::size_t i = 0;
+#if defined(RL_SIMD_NEON)
+            float64x2_t q0 = vdupq_n_f64(0), q1 = q0, q2 = q0, q3 = q0;
+            for (; i + 8 <= n; i += 8) {
+                q0 = vaddq_f64(q0, vld1q_f64(p + i));
+                q1 = vaddq_f64(q1, vld1q_f64(p + i + 2));
+                q2 = vaddq_f64(q2, vld1q_f64(p + i + 4));
+                q3 = vaddq_f64(q3, vld1q_f64(p + i + 6));
+            }
+            double t[8];
+            vst1q_f64(t, q0); vst1q_f64(t + 2, q1); vst1q_f64(t + 4, q2); vst1q_f64(t + 6, q3);
+#else
+            double t[8] = {};
+            for (; i + 8 <= n; i += 8) {
+                for (int k = 0; k < 8; ++k) t[k] += p[i + k];
+            }
+#endif
+            double total = fold_lanes(t);
+            for (; i < n; ++i) total += p[i];
+            return total;
+        }
+
+        inline double dot_f64(const double* a, const double* b, std::size_t n) {
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                return dot_f64_avx2(a, b, n);
+            }
+#endif
+            std::size_t i = 0;
+#if defined(RL_SIMD_NEON)
+            float64x2_t q0 = vdupq_n_f64(0), q1 = q0, q2 = q0, q3 = q0;
+            for (; i + 8 <= n; i += 8) {
+                q0 = vaddq_f64(q0, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+                q1 = vaddq_f64(q1, vmulq_f64(vld1q_f64(a + i + 2), vld1q_f64(b + i + 2)));
+                q2 = vaddq_f64(q2, vmulq_f64(vld1q_f64(a + i + 4), vld1q_f64(b + i + 4)));
+                q3 = vaddq_f64(q3, vmulq_f64(vld1q_f64(a + i + 6), vld1q_f64(b + i + 6)));
+            }
+            double t[8];
+            vst1q_f64(t, q0); vst1q_f64(t + 2, q1); vst1q_f64(t + 4, q2); vst1q_f64(t + 6, q3);
+#else
+            double t[8] = {};
+            for (; i + 8 <= n; i += 8) {
+                for (int k = 0; k < 8; ++k) t[k] += a[i + k] * b[i + k];
+            }
+#endif
+            double total = fold_lanes(t);
+            for (; i < n; ++i) total += a[i] * b[i];
+            return total;
+        }
+
+        // Element-wise kernels: out[i] = Op(a[i], b[i]) for each vector width.
+        // Integer arithmetic wraps around on overflow, the same on every path.
+        struct AddOp {
+            static double scalar(double x, double y) { return x + y; }
+            static int scalar(int x, int y) { return static_cast<int>(static_cast<unsigned>(x) + static_cast<unsigned>(y)); }
+#if defined(RL_SIMD_AVX2)
+            RL_TARGET_AVX2 static __m256d avx2(__m256d x, __m256d y) { return _mm256_add_pd(x, y); }
+            RL_TARGET_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+#elif defined(RL_SIMD_NEON)
+            static float64x2_t neon(float64x2_t x, float64x2_t y) { return vaddq_f64(x, y); }
+            static int32x4_t neon(int32x4_t x, int32x4_t y) { return vaddq_s32(x, y); }
+#endif
+        };
+
+        struct SubOp {
+            static double scalar(double x, double y) { return x - y; }
+            static int scalar(int x, int y) { return static_cast<int>(static_cast<unsigned>(x) - static_cast<unsigned>(y)); }
+#if defined(RL_SIMD_AVX2)
+            RL_TARGET_AVX2 static __m256d avx2(__m256d x, __m256d y) { return _mm256_sub_pd(x, y); }
+            RL_TARGET_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_sub_epi32(x, y); }
+#elif defined(RL_SIMD_NEON)
+            static float64x2_t neon(float64x2_t x, float64x2_t y) { return vsubq_f64(x, y); }
+            static int32x4_t neon(int32x4_t x, int32x4_t y) { return vsubq_s32(x, y); }
+#endif
+        };
+
+        struct MulOp {
+            static double scalar(double x, double y) { return x * y; }
+            static int scalar(int x, int y) { return static_cast<int>(static_cast<unsigned>(x) * static_cast<unsigned>(y)); }
+#if defined(RL_SIMD_AVX2)
+            RL_TARGET_AVX2 static __m256d avx2(__m256d x, __m256d y) { return _mm256_mul_pd(x, y); }
+            RL_TARGET_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_mullo_epi32(x, y); }
+#elif defined(RL_SIMD_NEON)
+            static float64x2_t neon(float64x2_t x, float64x2_t y) { return vmulq_f64(x, y); }
+            static int32x4_t neon(int32x4_t x, int32x4_t y) { return vmulq_s32(x, y); }
+#endif
+        };
+
+        // The vector forms keep the scalar forms' operand order, so a NaN is
+        // treated the same in every lane and in the tail: only a NaN in the
+        // running result (the first element) sticks. min_pd(a, b) is a < b ? a : b.
+        struct MinOp {
+            static double scalar(double x, double y) { return y < x ? y : x; }
+            static int scalar(int x, int y) { return y < x ? y : x; }
+#if defined(RL_SIMD_AVX2)
+            RL_TARGET_AVX2 static __m256d avx2(__m256d x, __m256d y) { return _mm256_min_pd(y, x); }
+            RL_TARGET_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_min_epi32(x, y); }
+#elif defined(RL_SIMD_NEON)
+            // vminq_f64 returns NaN if either operand is NaN, so select instead.
+            static float64x2_t neon(float64x2_t x, float64x2_t y) { return vbslq_f64(vcltq_f64(y, x), y, x); }
+            static int32x4_t neon(int32x4_t x, int32x4_t y) { return vminq_s32(x, y); }
+#endif
+        };
+
+        struct MaxOp {
+            static double scalar(double x, double y) { return x < y ? y : x; }
+            static int scalar(int x, int y) { return x < y ? y : x; }
+#if defined(RL_SIMD_AVX2)
+            RL_TARGET_AVX2 static __m256d avx2(__m256d x, __m256d y) { return _mm256_max_pd(y, x); }
+            RL_TARGET_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_max_epi32(x, y); }
+#elif defined(RL_SIMD_NEON)
+            static float64x2_t neon(float64x2_t x, float64x2_t y) { return vbslq_f64(vcltq_f64(x, y), y, x); }
+            static int32x4_t neon(int32x4_t x, int32x4_t y) { return vmaxq_s32(x, y); }
+#endif
+        };
+
+        // Loads, stores and splats for the two element types, so the kernels
+        // below are written once.
+        struct F64 {
+            using scalar = double;
+#if defined(RL_SIMD_AVX2)
+            using avx2_vec = __m256d;
+            static constexpr std::size_t avx2_width = 4;
+            RL_TARGET_AVX2 static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+            RL_TARGET_AVX2 static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+            RL_TARGET_AVX2 static __m256d splat(double x) { return _mm256_set1_pd(x); }
+#elif defined(RL_SIMD_NEON)
+            using neon_vec = float64x2_t;
+            static constexpr std::size_t neon_width = 2;
+            static float64x2_t load(const double* p) { return vld1q_f64(p); }
+            static void store(double* p, float64x2_t v) { vst1q_f64(p, v); }
+            static float64x2_t splat(double x) { return vdupq_n_f64(x); }
+#endif
+        };
+
+        struct I32 {
+            using scalar = int;
+#if defined(RL_SIMD_AVX2)
+            using avx2_vec = __m256i;
+            static constexpr std::size_t avx2_width = 8;
+            RL_TARGET_AVX2 static __m256i load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            RL_TARGET_AVX2 static void store(int* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+            RL_TARGET_AVX2 static __m256i splat(int x) { return _mm256_set1_epi32(x); }
+#elif defined(RL_SIMD_NEON)
+            using neon_vec = int32x4_t;
+            static constexpr std::size_t neon_width = 4;
+            static int32x4_t load(const int* p) { return vld1q_s32(p); }
+            static void store(int* p, int32x4_t v) { vst1q_s32(p, v); }
+            static int32x4_t splat(int x) { return vdupq_n_s32(x); }
+#endif
+        };
+
+#if defined(RL_SIMD_AVX2)
+        template<typename Op, typename V, typename T>
+        RL_TARGET_AVX2 void zip_avx2(T* out, const T* a, const T* b, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + V::avx2_width <= n; i += V::avx2_width) {
+                V::store(out + i, Op::avx2(V::load(a + i), V::load(b + i)));
+            }
+            for (; i < n; ++i) out[i] = Op::scalar(a[i], b[i]);
+        }
+
+        template<typename Op, typename V, typename T>
+        RL_TARGET_AVX2 void zip_scalar_avx2(T* out, const T* a, T k, std::size_t n) {
+            std::size_t i = 0;
+            typename V::avx2_vec kv = V::splat(k);
+            for (; i + V::avx2_width <= n; i += V::avx2_width) {
+                V::store(out + i, Op::avx2(V::load(a + i), kv));
+            }
+            for (; i < n; ++i) out[i] = Op::scalar(a[i], k);
+        }
+
+        // Folds with Op across the whole range (min/max; n > 0).
+        template<typename Op, typename V, typename T>
+        RL_TARGET_AVX2 T fold_avx2(const T* p, std::size_t n) {
+            std::size_t i = 0;
+            T result = p[0];
+            if (n >= V::avx2_width) {
+                typename V::avx2_vec acc = V::load(p);
+                for (i = V::avx2_width; i + V::avx2_width <= n; i += V::avx2_width) {
+                    acc = Op::avx2(acc, V::load(p + i));
+                }
+                T lanes[V::avx2_width];
+                V::store(lanes, acc);
+                result = lanes[0];
+                for (std::size_t k = 1; k < V::avx2_width; ++k) result = Op::scalar(result, lanes[k]);
+            }
+            for (; i < n; ++i) result = Op::scalar(result, p[i]);
+            return result;
+        }
+#endif
+
+        template<typename Op, typename V, typename T>
+        inline void zip(T* out, const T* a, const T* b, std::size_t n) {
+            std::size_t i = 0;
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                zip_avx2<Op, V>(out, a, b, n);
+                return;
+            }
+#elif defined(RL_SIMD_NEON)
+            for (; i + V::neon_width <= n; i += V::neon_width) {
+                V::store(out + i, Op::neon(V::load(a + i), V::load(b + i)));
+            }
+#endif
+            for (; i < n; ++i) out[i] = Op::scalar(a[i], b[i]);
+        }
+
+        template<typename Op, typename V, typename T>
+        inline void zip_scalar(T* out, const T* a, T k, std::size_t n) {
+            std::size_t i = 0;
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                zip_scalar_avx2<Op, V>(out, a, k, n);
+                return;
+            }
+#elif defined(RL_SIMD_NEON)
+            typename V::neon_vec kv = V::splat(k);
+            for (; i + V::neon_width <= n; i += V::neon_width) {
+                V::store(out + i, Op::neon(V::load(a + i), kv));
+            }
+#endif
+            for (; i < n; ++i) out[i] = Op::scalar(a[i], k);
+        }
+
+        template<typename Op, typename V, typename T>
+        inline T fold(const T* p, std::size_t n) {
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                return fold_avx2<Op, V>(p, n);
+            }
+#endif
+            std::size_t i = 1;
+            T result = p[0];
+#if defined(RL_SIMD_NEON)
+            if (n >= V::neon_width) {
+                typename V::neon_vec acc = V::load(p);
+                for (i = V::neon_width; i + V::neon_width <= n; i += V::neon_width) {
+                    acc = Op::neon(acc, V::load(p + i));
+                }
+                T lanes[V::neon_width];
+                V::store(lanes, acc);
+                result = lanes[0];
+                for (std::size_t k = 1; k < V::neon_width; ++k) result = Op::scalar(result, lanes[k]);
+            }
+#endif
+            for (; i < n; ++i) result = Op::scalar(result, p[i]);
+            return result;
+        }
+
+        inline void sqrt_f64(double* out, const double* p, std::size_t n) {
+#if defined(RL_SIMD_AVX2)
+            if (has_avx2()) {
+                sqrt_f64_avx2(out, p, n);
+                return;
+            }
+#endif
+            std::size_t i = 0;
+#if defined(RL_SIMD_NEON)
+            for (; i + 2 <= n; i += 2) {
+                vst1q_f64(out + i, vsqrtq_f64(vld1q_f64(p + i)));
+            }
+#endif
+            for (; i < n; ++i) out[i] = std::sqrt(p[i]);
+        }
+
+        template<typename T>
+        inline void require_same_length(const std::vector<T>& a, const std::vector<T>& b, const char* what) {
+            if (a.size() != b.size()) {
+                throw std::invalid_argument(std::string(what) + "() needs lists of the same length");
+            }
+        }
+
+        template<typename T>
+        inline void require_non_empty(const std::vector<T>& xs, const char* what) {
+            if (xs.empty()) {
+                throw std::invalid_argument(std::string(what) + "() of an empty list");
+            }
+        }
+    }
+
+    // Sum of all elements (0 for an empty list). Integer sums wrap around on overflow.
+    inline double sum(const std::vector<double>& xs) { return detail::sum_f64(xs.data(), xs.size()); }
+
+    inline int sum(const std::vector<int>& xs) {
+        unsigned total = 0;
+        for (int x : xs) total += static_cast<unsigned>(x); // Wrapping add; the compiler vectorizes this on its own.
+        return static_cast<int>(total);
+    }
+
+    // Sum of a[i] * b[i]. Throws if the lengths differ.
+    inline double dot(const std::vector<double>& a, const std::vector<double>& b) {
+        detail::require_same_length(a, b, "dot");
+        return detail::dot_f64(a.data(), b.data(), a.size());
+    }
+
+    inline int dot(const std::vector<int>& a, const std::vector<int>& b) {
+        detail::require_same_length(a, b, "dot");
+        unsigned total = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) total += static_cast<unsigned>(a[i]) * static_cast<unsigned>(b[i]);
+        return static_cast<int>(total);
+    }
+
+    // Smallest / largest element. Throws on an empty list.
+    inline double min(const std::vector<double>& xs) {
+        detail::require_non_empty(xs, "min");
+        return detail::fold<detail::MinOp, detail::F64>(xs.data(), xs.size());
+    }
+
+    inline int min(const std::vector<int>& xs) {
+        detail::require_non_empty(xs, "min");
+        return detail::fold<detail::MinOp, detail::I32>(xs.data(), xs.size());
+    }
+
+    inline double max(const std::vector<double>& xs) {
+        detail::require_non_empty(xs, "max");
+        return detail::fold<detail::MaxOp, detail::F64>(xs.data(), xs.size());
+    }
+
+    inline int max(const std::vector<int>& xs) {
+        detail::require_non_empty(xs, "max");
+        return detail::fold<detail::MaxOp, detail::I32>(xs.data(), xs.size());
+    }
+
+    // Element-wise arithmetic, returning a new list: add(a, b)[i] == a[i] + b[i].
+    // The two lists must have the same length.
+    inline std::vector<double> add(const std::vector<double>& a, const std::vector<double>& b) {
+        detail::require_same_length(a, b, "add");
+        std::vector<double> out(a.size());
+        detail::zip<detail::AddOp, detail::F64>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    inline std::vector<int> add(const std::vector<int>& a, const std::vector<int>& b) {
+        detail::require_same_length(a, b, "add");
+        std::vector<int> out(a.size());
+        detail::zip<detail::AddOp, detail::I32>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    inline std::vector<double> sub(const std::vector<double>& a, const std::vector<double>& b) {
+        detail::require_same_length(a, b, "sub");
+        std::vector<double> out(a.size());
+        detail::zip<detail::SubOp, detail::F64>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    inline std::vector<int> sub(const std::vector<int>& a, const std::vector<int>& b) {
+        detail::require_same_length(a, b, "sub");
+        std::vector<int> out(a.size());
+        detail::zip<detail::SubOp, detail::I32>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    inline std::vector<double> mul(const std::vector<double>& a, const std::vector<double>& b) {
+        detail::require_same_length(a, b, "mul");
+        std::vector<double> out(a.size());
+        detail::zip<detail::MulOp, detail::F64>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    inline std::vector<int> mul(const std::vector<int>& a, const std::vector<int>& b) {
+        detail::require_same_length(a, b, "mul");
+        std::vector<int> out(a.size());
+        detail::zip<detail::MulOp, detail::I32>(out.data(), a.data(), b.data(), a.size());
+        return out;
+    }
+
+    // Every element multiplied by k.
+    inline std::vector<double> scale(const std::vector<double>& xs, double k) {
+        std::vector<double> out(xs.size());
+        detail::zip_scalar<detail::MulOp, detail::F64>(out.data(), xs.data(), k, xs.size());
+        return out;
+    }
+
+    inline std::vector<int> scale(const std::vector<int>& xs, int k) {
+        std::vector<int> out(xs.size());
+        detail::zip_scalar<detail::MulOp, detail::I32>(out.data(), xs.data(), k, xs.size());
+        return out;
+    }
+
+    // Square root of every element.
+    inline std::vector<double> map_sqrt(const std::vector<double>& xs) {
+        std::vector<double> out(xs.size());
+        detail::sqrt_f64(out.data(), xs.data(), xs.size());
+        return out;
+    }
 }
 
 #endif // RL_MATH_HPP
@@ -0,0 +1,75 @@
+#ifndef RL_OBJECT_HPP
+#define RL_OBJECT_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "rl_arena.hpp"
+
+namespace rl {
+
+    // How objects of a REDLINE class are held. Generated code never names
+    // std::shared_ptr directly: it writes rl::ref<T> and rl::make<T>(...), and
+    // each class picks its ownership by specializing object_traits. That way a
+    // module using an imported class doesn't need to know how it was declared.
+
+    // `class`: shared ownership, reference counted. The default.
+    // Inside `with arena:` the object and its control block come from the arena.
+    template<typename T>
+    struct shared_traits {
+        using handle = std::shared_ptr<T>;
+        using param = const handle&;
+
+        template<typename... Args>
+        static handle make(Args&&... args) {
+            if (std::pmr::memory_resource* arena = detail::current_arena()) {
+                return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(arena), std::forward<Args>(args)...);
+            }
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+    };
+
+    // `unique class`: a single owner, no reference count. Hand it over with `move`.
+    // Always on the heap: std::unique_ptr's deleter can't give memory back to an arena.
+    template<typename T>
+    struct unique_traits {
+        using handle = std::unique_ptr<T>;
+        using param = const handle&; // Borrowed: the object can be changed, the owner can't.
+
+        template<typename... Args>
+        static handle make(Args&&... args) { return std::make_unique<T>(std::forward<Args>(args)...); }
+    };
+
+    // `struct`: a plain value, stored inline in variables, lists and dicts.
+    // Assigning or passing it copies it.
+    template<typename T>
+    struct value_traits {
+        using handle = T;
+        using param = T; // The callee changes its own copy.
+
+        template<typename... Args>
+        static handle make(Args&&... args) { return T(std::forward<Args>(args)...); }
+    };
+
+    template<typename T>
+    struct object_traits : shared_traits<T> {};
+
+    // The type a REDLINE variable of class type T actually has.
+    template<typename T>
+    using ref = typename object_traits<T>::handle;
+
+    // The parameter type for a callee that modifies the object (sets fields,
+    // calls methods) without reassigning the variable itself.
+    template<typename T>
+    using param = typename object_traits<T>::param;
+
+    // What `new T(args)` compiles to.
+    template<typename T, typename... Args>
+    inline ref<T> make(Args&&... args) {
+        return object_traits<T>::make(std::forward<Args>(args)...);
+    }
+
+} // namespace rl
+
+#endif // RL_OBJECT_HPP
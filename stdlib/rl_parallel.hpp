@@ -0,0 +1,305 @@
+#ifndef RL_PARALLEL_HPP
+#define RL_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rl {
+
+    namespace detail {
+        // A half-open range of iteration offsets packed into one 64-bit atomic,
+        // so the owner taking from the front and thieves splitting off the back
+        // never need a lock.
+        class WorkRange {
+        public:
+            void assign(std::uint32_t begin, std::uint32_t end) {
+                bits_.store(pack(begin, end), std::memory_order_release);
+            }
+
+            // Owner: takes up to `grain` iterations from the front.
+            bool take_front(std::uint32_t grain, std::uint32_t& begin, std::uint32_t& end) {
+                std::uint64_t old = bits_.load(std::memory_order_acquire);
+                for (;;) {
+                    std::uint32_t b = low(old), e = high(old);
+                    if (b >= e) {
+                        return false;
+                    }
+                    std::uint32_t taken = std::min(grain, e - b);
+                    if (bits_.compare_exchange_weak(old, pack(b + taken, e), std::memory_order_acq_rel)) {
+                        begin = b;
+                        end = b + taken;
+                        return true;
+                    }
+                }
+            }
+
+            // Thief: takes the back half of whatever is left.
+            bool steal_back(std::uint32_t& begin, std::uint32_t& end) {
+                std::uint64_t old = bits_.load(std::memory_order_acquire);
+                for (;;) {
+                    std::uint32_t b = low(old), e = high(old);
+                    if (b >= e) {
+                        return false;
+                    }
+                    std::uint32_t mid = b + (e - b) / 2;
+                    if (bits_.compare_exchange_weak(old, pack(b, mid), std::memory_order_acq_rel)) {
+                        begin = mid;
+                        end = e;
+                        return true;
+                    }
+                }
+            }
+
+        private:
+            std::atomic<std::uint64_t> bits_{0};
+
+            static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+                return (static_cast<std::uint64_t>(end) << 32) | begin;
+            }
+            static std::uint32_t low(std::uint64_t bits) { return static_cast<std::uint32_t>(bits); }
+            static std::uint32_t high(std::uint64_t bits) { return static_cast<std::uint32_t>(bits >> 32); }
+        };
+
+        struct alignas(64) WorkSlot {
+            WorkRange range;
+        };
+
+        // True while a thread runs pool work: always on the workers, and on the
+        // calling thread while it runs its share. A parallel loop nested inside
+        // another then runs inline instead of waiting on workers that are all busy
+        // (or, on the calling thread, on the pool it is already running).
+        inline bool& inside_pool() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        // Sets inside_pool() for as long as it lives, and restores it afterwards,
+        // also when the work throws.
+        class PoolScope {
+        public:
+            PoolScope() : previous_(inside_pool()) { inside_pool() = true; }
+            ~PoolScope() { inside_pool() = previous_; }
+
+            PoolScope(const PoolScope&) = delete;
+            PoolScope& operator=(const PoolScope&) = delete;
+
+        private:
+            bool previous_;
+        };
+
+        // A persistent set of worker threads, started on first use. Each
+        // parallel loop wakes them once; the calling thread pitches in too.
+        // The thread count is cpu_count(), or REDLINE_THREADS if it's set.
+        class ThreadPool {
+        public:
+            static ThreadPool& instance() {
+                static ThreadPool pool;
+                return pool;
+            }
+
+            // Including the calling thread.
+            int participants() const { return static_cast<int>(workers_.size()) + 1; }
+
+            // Runs job(p) once for every participant p and waits for all of them.
+            void run(const std::function<void(int)>& job) {
+                std::lock_guard<std::mutex> one_job_at_a_time(run_mutex_);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    job_ = &job;
+                    pending_ = static_cast<int>(workers_.size());
+                    ++generation_;
+                }
+                wake_.notify_all();
+                {
+                    PoolScope scope;
+                    job(0);
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock, [this] { return pending_ == 0; });
+                job_ = nullptr;
+            }
+
+        private:
+            std::vector<std::thread> workers_;
+            std::mutex run_mutex_;
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::condition_variable done_;
+            const std::function<void(int)>* job_ = nullptr;
+            std::uint64_t generation_ = 0;
+            int pending_ = 0;
+            bool stopping_ = false;
+
+            ThreadPool() {
+                int threads = static_cast<int>(std::thread::hardware_concurrency());
+                if (const char* env = std::getenv("REDLINE_THREADS")) {
+                    threads = std::atoi(env);
+                }
+                for (int i = 1; i < threads; ++i) {
+                    workers_.emplace_back([this, i] { work(i); });
+                }
+            }
+
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                wake_.notify_all();
+                for (std::thread& worker : workers_) {
+                    worker.join();
+                }
+            }
+
+            void work(int participant) {
+                inside_pool() = true;
+                std::uint64_t seen = 0;
+                for (;;) {
+                    const std::function<void(int)>* job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                        if (stopping_) {
+                            return;
+                        }
+                        seen = generation_;
+                        job = job_;
+                    }
+                    (*job)(participant);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (--pending_ == 0) {
+                            done_.notify_one();
+                        }
+                    }
+                }
+            }
+        };
+
+        // Splits [begin, end) across the pool. Each participant starts on its own
+        // contiguous slice and, once that runs dry, steals half of someone else's
+        // remaining slice, so uneven iterations still balance out.
+        // chunk(p, b, e) runs iterations [b, e) on participant p.
+        template<typename Chunk>
+        inline void run_range(int begin, int end, const Chunk& chunk) {
+            if (end <= begin) {
+                return;
+            }
+            ThreadPool& pool = ThreadPool::instance();
+            int participants = pool.participants();
+            if (participants == 1 || inside_pool()) {
+                chunk(0, begin, end);
+                return;
+            }
+
+            std::uint32_t count = static_cast<std::uint32_t>(static_cast<std::int64_t>(end) - begin);
+            // Small enough to balance, large enough that scheduling stays cheap next to the body.
+            std::uint32_t grain = std::max<std::uint32_t>(1, count / (static_cast<std::uint32_t>(participants) * 32));
+            std::vector<WorkSlot> slots(participants);
+            for (int p = 0; p < participants; ++p) {
+                std::uint32_t slice_begin = static_cast<std::uint32_t>(static_cast<std::uint64_t>(count) * p / participants);
+                std::uint32_t slice_end = static_cast<std::uint32_t>(static_cast<std::uint64_t>(count) * (p + 1) / participants);
+                slots[p].range.assign(slice_begin, slice_end);
+            }
+
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            std::function<void(int)> job = [&](int p) {
+                try {
+                    std::uint32_t b, e;
+                    for (;;) {
+                        while (!failed.load(std::memory_order_relaxed) && slots[p].range.take_front(grain, b, e)) {
+                            chunk(p, begin + static_cast<int>(b), begin + static_cast<int>(e));
+                        }
+                        if (failed.load(std::memory_order_relaxed)) {
+                            return;
+                        }
+                        bool stole = false;
+                        for (int i = 1; i < participants && !stole; ++i) {
+                            stole = slots[(p + i) % participants].range.steal_back(b, e);
+                        }
+                        if (!stole) {
+                            return;
+                        }
+                        slots[p].range.assign(b, e);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            };
+            pool.run(job);
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // What `parallel for i in begin..end:` compiles to. body(b, e) runs the
+    // original loop body for i in [b, e); chunks run concurrently.
+    template<typename Body>
+    inline void parallel_for(int begin, int end, const Body& body) {
+        detail::run_range(begin, end, [&](int, int b, int e) { body(b, e); });
+    }
+
+    // Reduction operators for `parallel for ... reduce <op> into <var>:`.
+    struct reduce_sum {
+        template<typename T> static T identity() { return T(); }
+        template<typename T> T operator()(const T& a, const T& b) const { return a + b; }
+    };
+
+    struct reduce_product {
+        template<typename T> static T identity() { return T(1); }
+        template<typename T> T operator()(const T& a, const T& b) const { return a * b; }
+    };
+
+    struct reduce_min {
+        template<typename T> static T identity() { return std::numeric_limits<T>::max(); }
+        template<typename T> T operator()(const T& a, const T& b) const { return b < a ? b : a; }
+    };
+
+    struct reduce_max {
+        template<typename T> static T identity() { return std::numeric_limits<T>::lowest(); }
+        template<typename T> T operator()(const T& a, const T& b) const { return a < b ? b : a; }
+    };
+
+    // What `parallel for i in begin..end reduce <op> into total:` compiles to.
+    // Every participant accumulates into its own private copy of `total`, starting
+    // from the operator's identity; the copies are folded into `initial` at the end,
+    // so the body needs no locks. (Floating-point sums may round differently from
+    // run to run, because the partials are combined in a different order.)
+    template<typename T, typename Op, typename Body>
+    inline T parallel_reduce(int begin, int end, T initial, Op op, const Body& body) {
+        struct alignas(64) Partial {
+            T value;
+        };
+        int participants = detail::ThreadPool::instance().participants();
+        std::vector<Partial> partials(participants, Partial{ Op::template identity<T>() });
+        detail::run_range(begin, end, [&](int p, int b, int e) {
+            partials[p].value = body(b, e, partials[p].value);
+        });
+        T result = initial;
+        for (const Partial& partial : partials) {
+            result = op(result, partial.value);
+        }
+        return result;
+    }
+
+} // namespace rl
+
+#endif // RL_PARALLEL_HPP
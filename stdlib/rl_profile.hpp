@@ -0,0 +1,99 @@
+#ifndef RL_PROFILE_HPP
+#define RL_PROFILE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace rl {
+
+    // Scope timers for `redline build --profile=timers`. Every function body
+    // starts with
+    //     static thread_local int rl_profile_depth = 0;
+    //     static rl::profile_site rl_profile_site("name", "file.rl:12");
+    //     rl::profile_timer rl_profile_timer(rl_profile_site, rl_profile_depth);
+    // and the table of all sites is printed to stderr when the program exits.
+
+    // One instrumented function. Sites never go away, so the report at exit can
+    // read them without caring about destruction order.
+    class profile_site {
+    public:
+        profile_site(const char* name, const char* location) : name_(name), location_(location) {
+            next_ = head().load(std::memory_order_relaxed);
+            while (!head().compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            static const bool registered = (std::atexit(report), true);
+            (void)registered;
+        }
+
+        profile_site(const profile_site&) = delete;
+        profile_site& operator=(const profile_site&) = delete;
+
+        void record(std::int64_t ns, bool outermost) {
+            calls_.fetch_add(1, std::memory_order_relaxed);
+            if (outermost) {
+                total_ns_.fetch_add(ns, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        const char* name_;
+        const char* location_;
+        std::atomic<std::uint64_t> calls_{0};
+        std::atomic<std::int64_t> total_ns_{0};
+        profile_site* next_ = nullptr;
+
+        static std::atomic<profile_site*>& head() {
+            static std::atomic<profile_site*> sites{nullptr};
+            return sites;
+        }
+
+        // Inclusive time: a function's time includes the functions it calls,
+        // and a recursive call counts as a call but not again as time.
+        static void report() {
+            std::vector<const profile_site*> sites;
+            for (const profile_site* site = head().load(std::memory_order_acquire); site; site = site->next_) {
+                sites.push_back(site);
+            }
+            std::sort(sites.begin(), sites.end(), [](const profile_site* a, const profile_site* b) {
+                return a->total_ns_.load() > b->total_ns_.load();
+            });
+            std::fprintf(stderr, "\n%-32s %-24s %12s %14s %14s\n", "function", "location", "calls", "total ms", "per call us");
+            for (const profile_site* site : sites) {
+                std::uint64_t calls = site->calls_.load();
+                double total_ms = site->total_ns_.load() / 1e6;
+                std::fprintf(stderr, "%-32s %-24s %12llu %14.3f %14.3f\n", site->name_, site->location_,
+                    static_cast<unsigned long long>(calls), total_ms, calls ? total_ms * 1e3 / calls : 0.0);
+            }
+        }
+    };
+
+    // Times one call, from construction to the end of the enclosing scope.
+    class profile_timer {
+    public:
+        profile_timer(profile_site& site, int& depth)
+            : site_(site), depth_(depth), start_(std::chrono::steady_clock::now()) {
+            ++depth_;
+        }
+
+        ~profile_timer() {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+            site_.record(ns, --depth_ == 0);
+        }
+
+        profile_timer(const profile_timer&) = delete;
+        profile_timer& operator=(const profile_timer&) = delete;
+
+    private:
+        profile_site& site_;
+        int& depth_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace rl
+
+#endif // RL_PROFILE_HPP
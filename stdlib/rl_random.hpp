@@ -1,28 +1,284 @@
 #ifndef RL_RANDOM_HPP
 #define RL_RANDOM_HPP
 
-#include <random>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 
 namespace rl {
 
-    // A simple random number generator.
-    // Seeded once to ensure different results on each run.
-    inline std::mt19937& get_random_engine() {
-        static std::mt19937 engine(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
-        return engine;
+    namespace detail {
+        inline std::uint64_t rotl(std::uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        // Turns any 64-bit seed into well-mixed generator state.
+        class SplitMix64 {
+        public:
+            explicit SplitMix64(std::uint64_t state) : state_(state) {}
+
+            std::uint64_t next() {
+                std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            }
+
+        private:
+            std::uint64_t state_;
+        };
+    }
+
+    // xoshiro256** (Blackman & Vigna): 32 bytes of state, a few cycles per
+    // number, and a 2^256 - 1 period. Usable with the <random> distributions.
+    class Xoshiro256 {
+    public:
+        using result_type = std::uint64_t;
+
+        explicit Xoshiro256(std::uint64_t seed = 0) {
+            detail::SplitMix64 mix(seed);
+            for (std::uint64_t& word : s_) {
+                word = mix.next();
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() {
+            const std::uint64_t result = detail::rotl(s_[1] * 5, 7) * 9;
+            const std::uint64_t t = s_[1] << 17;
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+            s_[2] ^= t;
+            s_[3] = detail::rotl(s_[3], 45);
+            return result;
+        }
+
+    private:
+        std::uint64_t s_[4];
+    };
+
+    namespace detail {
+        // Hands out one seed per thread engine. Stream k starts the SplitMix64
+        // sequence 4k steps after the base seed, so no two engines ever start
+        // from the same state.
+        class SeedSequence {
+        public:
+            static SeedSequence& instance() {
+                static SeedSequence sequence;
+                return sequence;
+            }
+
+            std::uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+            // The next unused stream's seed, and the generation it belongs to.
+            std::uint64_t claim(std::uint64_t& generation) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                generation = generation_.load(std::memory_order_relaxed);
+                return stream_seed(next_stream_++);
+            }
+
+            // Starts over from `seed`; the caller takes stream 0.
+            std::uint64_t reset(std::uint64_t seed, std::uint64_t& generation) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                base_ = seed;
+                next_stream_ = 1;
+                generation = generation_.load(std::memory_order_relaxed) + 1;
+                generation_.store(generation, std::memory_order_release);
+                return stream_seed(0);
+            }
+
+        private:
+            std::mutex mutex_;
+            std::uint64_t base_;
+            std::uint64_t next_stream_ = 0;
+            std::atomic<std::uint64_t> generation_{0};
+
+            SeedSequence()
+                : base_(static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())) {}
+
+            std::uint64_t stream_seed(std::uint64_t stream) const {
+                return base_ + stream * 4 * 0x9E3779B97F4A7C15ULL;
+            }
+        };
+
+        struct ThreadEngine {
+            Xoshiro256 engine;
+            std::uint64_t generation = std::numeric_limits<std::uint64_t>::max();
+        };
+
+        inline ThreadEngine& thread_engine_slot() {
+            thread_local ThreadEngine slot;
+            return slot;
+        }
+    }
+
+    // This thread's generator. Each thread has its own, so drawing numbers
+    // never takes a lock, and threads never see each other's sequences.
+    inline Xoshiro256& get_random_engine() {
+        detail::ThreadEngine& slot = detail::thread_engine_slot();
+        detail::SeedSequence& seeds = detail::SeedSequence::instance();
+        if (slot.generation != seeds.generation()) {
+            slot.engine = Xoshiro256(seeds.claim(slot.generation));
+        }
+        return slot.engine;
+    }
+
+    // Makes the random numbers reproducible: after seed(n), the calling
+    // thread produces the same sequence on every run. Every other thread
+    // switches to a fresh stream derived from n on its next draw.
+    inline void seed(int n) {
+        detail::ThreadEngine& slot = detail::thread_engine_slot();
+        slot.engine = Xoshiro256(detail::SeedSequence::instance().reset(static_cast<std::uint64_t>(static_cast<std::uint32_t>(n)), slot.generation));
+    }
+
+    namespace detail {
+        // Top 53 bits as a double in [0, 1).
+        inline double to_unit(std::uint64_t x) {
+            return static_cast<double>(x >> 11) * 0x1.0p-53;
+        }
+
+        inline void check_range(int min, int max) {
+            if (min > max) {
+                throw std::invalid_argument("random range is empty: min > max");
+            }
+        }
+
+        // Lemire's multiply-shift: maps a 32-bit draw onto [0, range) with
+        // one multiply; the rare draws that would bias it are redrawn.
+        inline std::uint32_t bounded(Xoshiro256& engine, std::uint32_t range) {
+            std::uint64_t m = static_cast<std::uint64_t>(static_cast<std::uint32_t>(engine() >> 32)) * range;
+            std::uint32_t low = static_cast<std::uint32_t>(m);
+            if (low < range) {
+                const std::uint32_t threshold = static_cast<std::uint32_t>(0u - range) % range;
+                while (low < threshold) {
+                    m = static_cast<std::uint64_t>(static_cast<std::uint32_t>(engine() >> 32)) * range;
+                    low = static_cast<std::uint32_t>(m);
+                }
+            }
+            return static_cast<std::uint32_t>(m >> 32);
+        }
+
+        inline int random_in(Xoshiro256& engine, int min, int max) {
+            std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+            std::uint32_t offset = range == 0 ? static_cast<std::uint32_t>(engine() >> 32) : bounded(engine, range); // range == 0: all of int.
+            return static_cast<int>(static_cast<std::uint32_t>(min) + offset);
+        }
+
+        // Four independent xoshiro256+ generators side by side, stored
+        // lane-major so each step is plain 64-bit shifts and xors the compiler
+        // turns into vector instructions. The '+' variant's weak low bits are
+        // never used: doubles and ints only take the top bits.
+        class BulkGenerator {
+        public:
+            static constexpr std::size_t lanes = 4;
+
+            explicit BulkGenerator(Xoshiro256& engine) {
+                for (std::size_t lane = 0; lane < lanes; ++lane) {
+                    SplitMix64 mix(engine());
+                    for (std::size_t word = 0; word < 4; ++word) {
+                        s_[word][lane] = mix.next();
+                    }
+                }
+            }
+
+            void next(std::uint64_t* out) {
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    out[k] = s_[0][k] + s_[3][k];
+                    const std::uint64_t t = s_[1][k] << 17;
+                    s_[2][k] ^= s_[0][k];
+                    s_[3][k] ^= s_[1][k];
+                    s_[1][k] ^= s_[2][k];
+                    s_[0][k] ^= s_[3][k];
+                    s_[2][k] ^= t;
+                    s_[3][k] = (s_[3][k] << 45) | (s_[3][k] >> 19);
+                }
+            }
+
+        private:
+            alignas(32) std::uint64_t s_[4][lanes];
+        };
+
+        // Below this, setting up the bulk generator costs more than it saves.
+        constexpr std::size_t bulk_threshold = 64;
     }
 
     // Generates a random integer between min and max (inclusive).
     inline int random_int(int min, int max) {
-        std::uniform_int_distribution<int> dist(min, max);
-        return dist(get_random_engine());
+        detail::check_range(min, max);
+        return detail::random_in(get_random_engine(), min, max);
     }
 
-    // Generates a random float between 0.0 and 1.0.
+    // Generates a random float between 0.0 and 1.0 (excluding 1.0).
     inline double random_float() {
-        std::uniform_real_distribution<double> dist(0.0, 1.0);
-        return dist(get_random_engine());
+        return detail::to_unit(get_random_engine()());
+    }
+
+    // n random floats in [0.0, 1.0), generated in one pass.
+    inline std::vector<double> random_floats(int n) {
+        std::vector<double> out(n > 0 ? static_cast<std::size_t>(n) : 0);
+        Xoshiro256& engine = get_random_engine();
+        std::size_t i = 0;
+        if (out.size() >= detail::bulk_threshold) {
+            detail::BulkGenerator bulk(engine);
+            std::uint64_t draws[detail::BulkGenerator::lanes];
+            const std::size_t blocks_end = out.size() - out.size() % detail::BulkGenerator::lanes;
+            for (; i < blocks_end; i += detail::BulkGenerator::lanes) {
+                bulk.next(draws);
+                for (std::size_t k = 0; k < detail::BulkGenerator::lanes; ++k) {
+                    out[i + k] = detail::to_unit(draws[k]);
+                }
+            }
+        }
+        for (; i < out.size(); ++i) {
+            out[i] = detail::to_unit(engine());
+        }
+        return out;
+    }
+
+    // n random integers between min and max (inclusive), generated in one pass.
+    inline std::vector<int> random_ints(int n, int min, int max) {
+        detail::check_range(min, max);
+        std::vector<int> out(n > 0 ? static_cast<std::size_t>(n) : 0);
+        Xoshiro256& engine = get_random_engine();
+        const std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+        const std::size_t size = out.size();
+        std::size_t i = 0;
+        if (size >= detail::bulk_threshold && range != 0) {
+            // The same multiply-shift as random_int, without a branch per draw:
+            // a block containing a biased draw (rare) is redrawn exactly.
+            const std::uint32_t threshold = static_cast<std::uint32_t>(0u - range) % range;
+            detail::BulkGenerator bulk(engine);
+            std::uint64_t draws[detail::BulkGenerator::lanes];
+            std::uint32_t offsets[detail::BulkGenerator::lanes];
+            // Whole blocks end here; a bound GCC can follow, unlike i + lanes <= size.
+            const std::size_t blocks_end = size - size % detail::BulkGenerator::lanes;
+            for (; i < blocks_end; i += detail::BulkGenerator::lanes) {
+                bulk.next(draws);
+                bool biased = false;
+                for (std::size_t k = 0; k < detail::BulkGenerator::lanes; ++k) {
+                    std::uint64_t m = (draws[k] >> 32) * range;
+                    biased |= static_cast<std::uint32_t>(m) < threshold;
+                    offsets[k] = static_cast<std::uint32_t>(m >> 32);
+                }
+                for (std::size_t k = 0; k < detail::BulkGenerator::lanes; ++k) {
+                    out[i + k] = biased ? detail::random_in(engine, min, max)
+                                        : static_cast<int>(static_cast<std::uint32_t>(min) + offsets[k]);
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            out[i] = detail::random_in(engine, min, max);
+        }
+        return out;
     }
 
 } // namespace rl
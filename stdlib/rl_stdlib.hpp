@@ -3,7 +3,14 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <algorithm> // For sort, reverse, find
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 
 namespace rl {
     // Global command line arguments
@@ -15,12 +22,73 @@ namespace rl {
         return vec.size();
     }
 
+    // Returns the number of bytes in a string (or a view of one).
+    inline int len(std::string_view s) {
+        return static_cast<int>(s.size());
+    }
+
+    // Element access the compiler has proven to be in bounds (`for i in 0..len(xs)`
+    // with xs never resized in the loop). Release builds (NDEBUG) skip the check so
+    // the loop can vectorize; debug builds keep .at() in case the proof is wrong.
+    template<typename Container>
+    inline decltype(auto) at_in_range(Container& c, int index) {
+#ifdef NDEBUG
+        return c[index];
+#else
+        return c.at(index);
+#endif
+    }
+
+    // Explicit unchecked access for hot loops the compiler can't prove safe.
+    // Out-of-range indices are undefined behaviour in release builds; debug builds
+    // still throw, so test in debug first.
+    template<typename Container>
+    inline decltype(auto) unsafe_get(Container& c, int index) {
+#ifdef NDEBUG
+        return c[index];
+#else
+        return c.at(index);
+#endif
+    }
+
+    // `xs[i] = value`, bounds-checked like reading xs[i].
+    // rl_dict.hpp overloads it for dicts, where assigning adds missing keys.
+    template<typename T>
+    inline void set_entry(std::vector<T>& vec, int index, typename std::vector<T>::value_type value) {
+        vec.at(index) = std::move(value);
+    }
+
+    inline void set_entry(std::string& s, int index, char value) {
+        s.at(index) = value;
+    }
+
     // Appends an element to a vector.
     template<typename T>
     void append(std::vector<T>& vec, const T& value) {
         vec.push_back(value);
     }
 
+    // Appends a temporary (or moved) element without copying it. This is what
+    // lets lists hold unique objects.
+    template<typename T>
+    void append(std::vector<T>& vec, T&& value) {
+        vec.emplace_back(std::move(value));
+    }
+
+    namespace detail {
+        // Another type an element can be built from, short of turning a float into an int.
+        template<typename T, typename U>
+        constexpr bool appendable_v = !std::is_same_v<std::decay_t<U>, T> && std::is_constructible_v<T, U&&>
+            && !(std::is_integral_v<T> && std::is_floating_point_v<std::decay_t<U>>);
+    }
+
+    // Appends anything an element can be made from (a string literal to a
+    // list[string], an int to a list[float]), building it in place.
+    template<typename T, typename U, typename = std::enable_if_t<detail::appendable_v<T, U>>>
+    void append(std::vector<T>& vec, U&& value) {
+        vec.emplace_back(std::forward<U>(value));
+    }
+
     // Sorts a vector in ascending order.
     // Warning: This modifies the list in place. Chaos is order.
     template<typename T>
@@ -46,6 +114,67 @@ namespace rl {
         return -1;
     }
 
+    // --- Capacity ---
+    // Lists grow by reallocating and moving every element. When the final size
+    // is known up front, reserving it first makes the appends allocation-free.
+
+    namespace detail {
+        inline std::size_t list_size(int n, const char* function) {
+            if (n < 0) {
+                throw std::invalid_argument(std::string(function) + ": size can't be negative");
+            }
+            return static_cast<std::size_t>(n);
+        }
+    }
+
+    // `list[T](n)`: an empty list with room for n elements.
+    template<typename T>
+    std::vector<T> with_capacity(int n) {
+        std::vector<T> vec;
+        vec.reserve(detail::list_size(n, "list"));
+        return vec;
+    }
+
+    // A list literal whose elements are built straight into the list: one
+    // allocation, and no copy through an initializer_list.
+    template<typename T, typename... Args>
+    std::vector<T> list_of(Args&&... values) {
+        std::vector<T> vec;
+        vec.reserve(sizeof...(Args));
+        (vec.emplace_back(std::forward<Args>(values)), ...);
+        return vec;
+    }
+
+    // Makes room for at least n elements in total. Never shrinks the list.
+    template<typename T>
+    void reserve(std::vector<T>& vec, int n) {
+        vec.reserve(detail::list_size(n, "reserve"));
+    }
+
+    // Grows or shrinks the list to n elements; new elements are 0, "", false or empty.
+    template<typename T>
+    void resize(std::vector<T>& vec, int n) {
+        vec.resize(detail::list_size(n, "resize"));
+    }
+
+    // Removes every element but keeps the memory, so refilling doesn't reallocate.
+    template<typename T>
+    void clear(std::vector<T>& vec) {
+        vec.clear();
+    }
+
+    // Gives back memory the list isn't using (for instance after clear()).
+    template<typename T>
+    void shrink_to_fit(std::vector<T>& vec) {
+        vec.shrink_to_fit();
+    }
+
+    // How many elements the list can hold before it has to reallocate.
+    template<typename T>
+    int capacity(const std::vector<T>& vec) {
+        return static_cast<int>(vec.capacity());
+    }
+
     // --- Type Conversion Helpers ---
 
     // Identity function for strings.
@@ -53,20 +182,81 @@ namespace rl {
         return s;
     }
 
-    // Wrapper for std::to_string (int)
     inline std::string to_string(int val) {
-        return std::to_string(val);
+        char buf[16];
+        auto result = std::to_chars(buf, buf + sizeof(buf), val);
+        return std::string(buf, result.ptr);
     }
 
-    // Wrapper for std::to_string (double)
+    // The shortest text that reads back as the same double (0.1 -> "0.1").
     inline std::string to_string(double val) {
-        return std::to_string(val);
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), val);
+        return std::string(buf, result.ptr);
     }
 
     // Wrapper for std::to_string (bool)
     inline std::string to_string(bool val) {
         return val ? "true" : "false";
     }
+
+    namespace detail {
+        // Parses all of `text` as a number with std::from_chars: no locale, no
+        // allocation. Surrounding spaces and a leading '+' are allowed, as with
+        // std::stoi; anything else left over is an error.
+        template<typename T>
+        std::errc parse_number(std::string_view text, T& out) {
+            auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+            while (!text.empty() && is_space(text.front())) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && is_space(text.back())) {
+                text.remove_suffix(1);
+            }
+            if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+                text.remove_prefix(1);
+            }
+            auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (result.ec == std::errc() && result.ptr != text.data() + text.size()) {
+                return std::errc::invalid_argument;
+            }
+            return result.ec;
+        }
+
+        template<typename T>
+        T to_number(std::string_view text, const char* name) {
+            T value{};
+            std::errc ec = parse_number(text, value);
+            if (ec == std::errc::result_out_of_range) {
+                throw std::out_of_range(std::string(name) + ": out of range: '" + std::string(text) + "'");
+            }
+            if (ec != std::errc()) {
+                throw std::invalid_argument(std::string(name) + ": not a number: '" + std::string(text) + "'");
+            }
+            return value;
+        }
+    }
+
+    // Parses an int. Throws invalid_argument on bad input, out_of_range if it doesn't fit.
+    inline int to_int(std::string_view text) {
+        return detail::to_number<int>(text, "to_int");
+    }
+
+    // Parses a float, including "1e-3", "inf" and "nan". Throws like to_int.
+    inline double to_float(std::string_view text) {
+        return detail::to_number<double>(text, "to_float");
+    }
+
+    // Like to_int and to_float, but gives back `fallback` instead of throwing.
+    inline int try_to_int(std::string_view text, int fallback) {
+        int value = 0;
+        return detail::parse_number(text, value) == std::errc() ? value : fallback;
+    }
+
+    inline double try_to_float(std::string_view text, double fallback) {
+        double value = 0;
+        return detail::parse_number(text, value) == std::errc() ? value : fallback;
+    }
 }
 
 #endif // RL_STDLIB_HPP
@@ -0,0 +1,31 @@
+#ifndef RL_STDLIB_ALL_HPP
+#define RL_STDLIB_ALL_HPP
+
+// The whole runtime in one header. redline.py precompiles it once per set of
+// compiler flags and force-includes it into every module, so the standard
+// library headers behind it are parsed once instead of per translation unit.
+// The includes are spelled the way generated code spells them, so its own
+// #includes of these headers are no-ops afterwards.
+
+#include "stdlib/rl_object.hpp"
+#include "stdlib/rl_io.hpp"
+#include "stdlib/rl_stdlib.hpp"
+#include "stdlib/rl_math.hpp"
+#include "stdlib/rl_dict.hpp"
+#include "stdlib/rl_file.hpp"
+#include "stdlib/rl_string.hpp"
+#include "stdlib/rl_random.hpp"
+#include "stdlib/rl_time.hpp"
+#include "stdlib/rl_bench.hpp"
+#include "stdlib/rl_thread.hpp"
+#include "stdlib/rl_parallel.hpp"
+#include "stdlib/rl_profile.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#endif // RL_STDLIB_ALL_HPP
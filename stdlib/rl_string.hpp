@@ -1,25 +1,51 @@
 #ifndef RL_STRING_H
 #define RL_STRING_H
 
+#include <charconv>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
 
 namespace rl {
 
     // Checks if a string contains a substring.
     // Returns true if the needle is found in the haystack.
-    inline bool contains(const std::string& haystack, const std::string& needle) {
-        return haystack.find(needle) != std::string::npos;
+    // Takes views, so passing a literal doesn't build a temporary string.
+    inline bool contains(std::string_view haystack, std::string_view needle) {
+        return haystack.find(needle) != std::string_view::npos;
     }
 
     // Splits a string into pieces based on a delimiter.
     // It's like taking a hammer to a vase, but for text.
-    inline std::vector<std::string> split(const std::string& s, const std::string& delimiter) {
+    inline std::vector<std::string> split(std::string_view s, std::string_view delimiter) {
         std::vector<std::string> tokens;
+        if (delimiter.empty()) {
+            tokens.emplace_back(s);
+            return tokens;
+        }
         size_t start = 0;
         size_t end = s.find(delimiter);
-        while (end != std::string::npos) {
+        while (end != std::string_view::npos) {
+            tokens.emplace_back(s.substr(start, end - start));
+            start = end + delimiter.length();
+            end = s.find(delimiter, start);
+        }
+        tokens.emplace_back(s.substr(start));
+        return tokens;
+    }
+
+    // Like split, but the pieces are views into the original string: no
+    // per-token allocations. The views are only valid while that string lives.
+    inline std::vector<std::string_view> split_view(std::string_view s, std::string_view delimiter) {
+        std::vector<std::string_view> tokens;
+        if (delimiter.empty()) {
+            tokens.push_back(s);
+            return tokens;
+        }
+        size_t start = 0;
+        size_t end = s.find(delimiter);
+        while (end != std::string_view::npos) {
             tokens.push_back(s.substr(start, end - start));
             start = end + delimiter.length();
             end = s.find(delimiter, start);
@@ -28,15 +54,179 @@ namespace rl {
         return tokens;
     }
 
+    inline std::vector<std::string_view> split_view(const std::string& s, std::string_view delimiter) {
+        return split_view(std::string_view(s), delimiter);
+    }
+
+    inline std::vector<std::string_view> split_view(const char* s, std::string_view delimiter) {
+        return split_view(std::string_view(s), delimiter);
+    }
+
+    // The views would point into a string that dies at the end of the statement.
+    std::vector<std::string_view> split_view(std::string&& s, std::string_view delimiter) = delete;
+
+    // Lazily walks the tokens of a string, for `for tok in tokenize(line, ","):`.
+    // Nothing is allocated; each token is a view found on demand.
+    // A temporary string passed in is kept alive by the range itself. The
+    // delimiter is always copied, since it can be a temporary too; it's
+    // usually short enough to stay in the string's inline buffer.
+    class TokenRange {
+    public:
+        class iterator {
+        public:
+            iterator(std::string_view text, std::string_view delimiter, bool done)
+                : text_(text), delimiter_(delimiter), done_(done) {
+                if (!done_) {
+                    find_end();
+                }
+            }
+
+            std::string_view operator*() const { return text_.substr(start_, end_ - start_); }
+
+            iterator& operator++() {
+                if (end_ == text_.size()) {
+                    done_ = true;
+                } else {
+                    start_ = end_ + delimiter_.size();
+                    find_end();
+                }
+                return *this;
+            }
+
+            bool operator!=(const iterator& other) const { return done_ != other.done_ || (!done_ && start_ != other.start_); }
+            bool operator==(const iterator& other) const { return !(*this != other); }
+
+        private:
+            std::string_view text_;
+            std::string_view delimiter_;
+            size_t start_ = 0;
+            size_t end_ = 0;
+            bool done_;
+
+            void find_end() {
+                end_ = delimiter_.empty() ? std::string_view::npos : text_.find(delimiter_, start_);
+                if (end_ == std::string_view::npos) {
+                    end_ = text_.size();
+                }
+            }
+        };
+
+        TokenRange(std::string_view text, std::string_view delimiter) : text_(text), delimiter_(delimiter) {}
+        TokenRange(std::string&& text, std::string_view delimiter)
+            : owned_(std::move(text)), text_(owned_), delimiter_(delimiter) {}
+
+        // text_ may point into owned_, and iterators into delimiter_, so the
+        // range stays where it was built.
+        TokenRange(const TokenRange&) = delete;
+        TokenRange& operator=(const TokenRange&) = delete;
+
+        iterator begin() const { return iterator(text_, delimiter_, false); }
+        iterator end() const { return iterator(text_, delimiter_, true); }
+
+    private:
+        std::string owned_;
+        std::string_view text_;
+        std::string delimiter_;
+    };
+
+    inline TokenRange tokenize(std::string_view s, std::string_view delimiter) {
+        return TokenRange(s, delimiter);
+    }
+
+    inline TokenRange tokenize(const std::string& s, std::string_view delimiter) {
+        return TokenRange(std::string_view(s), delimiter);
+    }
+
+    inline TokenRange tokenize(const char* s, std::string_view delimiter) {
+        return TokenRange(std::string_view(s), delimiter);
+    }
+
+    inline TokenRange tokenize(std::string&& s, std::string_view delimiter) {
+        return TokenRange(std::move(s), delimiter);
+    }
+
     // Joins a list of strings into a single string, separated by a delimiter.
     // It's the duct tape that puts the vase back together.
-    inline std::string join(const std::vector<std::string>& list, const std::string& delimiter) {
+    // The output size is computed first, so the result is allocated exactly once.
+    template<typename S>
+    inline std::string join(const std::vector<S>& list, std::string_view delimiter) {
+        if (list.empty()) {
+            return std::string();
+        }
+        size_t total = delimiter.size() * (list.size() - 1);
+        for (const auto& item : list) {
+            total += std::string_view(item).size();
+        }
         std::string result;
+        result.reserve(total);
         for (size_t i = 0; i < list.size(); ++i) {
-            result += list[i];
-            if (i < list.size() - 1) {
-                result += delimiter;
+            if (i > 0) {
+                result.append(delimiter.data(), delimiter.size());
+            }
+            std::string_view item(list[i]);
+            result.append(item.data(), item.size());
+        }
+        return result;
+    }
+
+    // Copies a view into an owning string.
+    inline std::string to_string(std::string_view s) {
+        return std::string(s);
+    }
+
+    namespace detail {
+        // One piece of a format() call, already rendered to text. Numbers are
+        // written into an inline buffer, strings are just viewed, so measuring
+        // the final length costs no allocations. Not copyable: the view may
+        // point into the object's own buffer.
+        class FormatArg {
+        public:
+            FormatArg(const std::string& s) : view_(s) {}
+            FormatArg(const char* s) : view_(s) {}
+            FormatArg(std::string_view s) : view_(s) {}
+            FormatArg(bool val) : view_(val ? "true" : "false") {}
+
+            FormatArg(int val) {
+                auto result = std::to_chars(buf_, buf_ + sizeof(buf_), val);
+                view_ = std::string_view(buf_, result.ptr - buf_);
             }
+
+            // Matches rl::to_string(double): shortest round-trip text.
+            FormatArg(double val) {
+                auto result = std::to_chars(buf_, buf_ + sizeof(buf_), val);
+                view_ = std::string_view(buf_, result.ptr - buf_);
+            }
+
+            FormatArg(const FormatArg&) = delete;
+            FormatArg& operator=(const FormatArg&) = delete;
+
+            std::string_view view() const { return view_; }
+
+        private:
+            // Large enough for any int, or any double in shortest form ("-2.2250738585072014e-308").
+            char buf_[32];
+            std::string_view view_;
+        };
+    }
+
+    inline std::string format() {
+        return std::string();
+    }
+
+    // Concatenates the text of all arguments into one string. This is what
+    // f-strings compile to: the result is sized once and filled in place,
+    // instead of allocating a temporary for every '+'.
+    template<typename... Args>
+    inline std::string format(const Args&... args) {
+        const detail::FormatArg pieces[] = { detail::FormatArg(args)... };
+        std::size_t total = 0;
+        for (const auto& piece : pieces) {
+            total += piece.view().size();
+        }
+        std::string result;
+        result.reserve(total);
+        for (const auto& piece : pieces) {
+            result.append(piece.view().data(), piece.view().size());
         }
         return result;
     }
@@ -0,0 +1,343 @@
+#ifndef RL_THREAD_HPP
+#define RL_THREAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace rl {
+
+    // Every type here is a small handle to shared state, so copying one (into a
+    // spawned function, a list, a parameter) refers to the same thread, lock or
+    // queue.
+
+    namespace detail {
+        constexpr std::size_t cache_line = 64;
+
+        // Spin briefly, then yield, then nap: cheap when the wait is short,
+        // polite to the rest of the machine when it isn't.
+        class Backoff {
+        public:
+            void wait() {
+                if (step_ < 64) {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+                    _mm_pause();
+#endif
+                } else if (step_ < 128) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+                if (step_ < 1024) {
+                    ++step_;
+                }
+            }
+
+        private:
+            int step_ = 0;
+        };
+    }
+
+    // --- Threads ---
+
+    // A running (or finished) spawned function. join() waits for it and returns
+    // its result, rethrowing anything it threw. The last handle to go away joins
+    // the thread, so a forgotten task can't take the program down.
+    template<typename T>
+    class task {
+    public:
+        task() = default;
+
+        task(std::shared_future<T> result, std::thread thread)
+            : state_(std::make_shared<State>(std::move(result), std::move(thread))) {}
+
+        T join() const {
+            if (!state_) {
+                throw std::runtime_error("join() on a task that was never spawned");
+            }
+            state_->wait();
+            if constexpr (std::is_void_v<T>) {
+                state_->result.get();
+            } else {
+                return state_->result.get();
+            }
+        }
+
+    private:
+        struct State {
+            std::shared_future<T> result;
+            std::thread thread;
+            std::mutex join_mutex;
+
+            State(std::shared_future<T> r, std::thread t) : result(std::move(r)), thread(std::move(t)) {}
+            ~State() { wait(); }
+
+            void wait() {
+                std::lock_guard<std::mutex> guard(join_mutex);
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+        };
+
+        std::shared_ptr<State> state_;
+    };
+
+    // What `spawn f(args)` compiles to: runs the call on a new thread.
+    template<typename F>
+    inline task<std::invoke_result_t<F>> spawn(F function) {
+        using R = std::invoke_result_t<F>;
+        std::packaged_task<R()> work(std::move(function));
+        std::shared_future<R> result = work.get_future().share();
+        std::thread thread(std::move(work));
+        return task<R>(std::move(result), std::move(thread));
+    }
+
+    template<typename T>
+    inline T join(const task<T>& t) {
+        return t.join();
+    }
+
+    // Number of hardware threads, or 1 if the platform won't say.
+    inline int cpu_count() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : static_cast<int>(n);
+    }
+
+    // --- Locks ---
+
+    // A mutual-exclusion lock. Use it with a `lock m:` block, which holds it
+    // until the block ends, even if an exception escapes.
+    class mutex {
+    public:
+        mutex() : native_(std::make_shared<std::mutex>()) {}
+
+        std::mutex& native() const { return *native_; }
+
+    private:
+        std::shared_ptr<std::mutex> native_;
+    };
+
+    // What `lock m:` compiles to.
+    class lock_scope {
+    public:
+        explicit lock_scope(const mutex& m) : guard_(m.native()) {}
+
+    private:
+        std::lock_guard<std::mutex> guard_;
+    };
+
+    // --- Atomics ---
+
+    // A value every thread can update without a lock, e.g. a shared counter:
+    //     val hits: atomic[int] = atomic(0)
+    //     hits.fetch_add(1)
+    // Supports std::atomic's load / store / fetch_add / fetch_sub / exchange.
+    template<typename T>
+    class atomic {
+    public:
+        explicit atomic(T initial = T()) : value_(std::make_shared<Slot>(initial)) {}
+
+        std::atomic<T>* operator->() const { return &value_->value; }
+
+    private:
+        // On its own cache line, so counters living side by side don't contend.
+        struct alignas(detail::cache_line) Slot {
+            std::atomic<T> value;
+            explicit Slot(T initial) : value(initial) {}
+        };
+
+        std::shared_ptr<Slot> value_;
+    };
+
+    // atomic(0) -> atomic<int>
+    template<typename T>
+    atomic(T) -> atomic<T>;
+
+    // --- Channels ---
+
+    // A bounded multi-producer / multi-consumer queue (Dmitry Vyukov's design).
+    // Each slot carries a sequence number that says whose turn it is, so sends and
+    // receives only contend on one atomic index each and never take a lock.
+    template<typename T>
+    class ChannelState {
+    public:
+        explicit ChannelState(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+            cells_ = std::make_unique<Cell[]>(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            mask_ = size - 1;
+        }
+
+        // Adds a value without blocking. Returns false if the channel is full.
+        bool try_send(T value) {
+            return try_send_ref(value);
+        }
+
+        // Adds a value, waiting while the channel is full.
+        void send(T value) {
+            detail::Backoff backoff;
+            while (!try_send_ref(value)) {
+                backoff.wait();
+            }
+        }
+
+        // Takes a value without blocking. Returns false if the channel is empty.
+        bool try_receive(T& out) {
+            return pop(out);
+        }
+
+        // Takes the next value, waiting while the channel is empty.
+        // Throws once the channel is closed and drained.
+        T receive() {
+            T value;
+            if (!receive_into(value)) {
+                throw std::runtime_error("receive on a closed, empty channel");
+            }
+            return value;
+        }
+
+        // Waits for the next value. Returns false once the channel is closed and drained.
+        bool receive_into(T& out) {
+            detail::Backoff backoff;
+            for (;;) {
+                if (pop(out)) {
+                    return true;
+                }
+                if (closed_.load(std::memory_order_acquire)) {
+                    // Everything sent before close() is visible now; take what's left.
+                    return pop(out);
+                }
+                backoff.wait();
+            }
+        }
+
+        // No more values will be sent. Receivers drain what's queued, then stop.
+        void close() { closed_.store(true, std::memory_order_release); }
+        bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+        int capacity() const { return static_cast<int>(mask_ + 1); }
+
+    private:
+        struct alignas(detail::cache_line) Cell {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        std::size_t mask_ = 0;
+        alignas(detail::cache_line) std::atomic<std::size_t> send_pos_{0};
+        alignas(detail::cache_line) std::atomic<std::size_t> receive_pos_{0};
+        alignas(detail::cache_line) std::atomic<bool> closed_{false};
+
+        bool try_send_ref(T& value) {
+            if (closed_.load(std::memory_order_relaxed)) {
+                throw std::runtime_error("send on a closed channel");
+            }
+            return push(value);
+        }
+
+        bool push(T& value) {
+            std::size_t pos = send_pos_.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells_[pos & mask_];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (send_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false; // Full.
+                } else {
+                    pos = send_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T& out) {
+            std::size_t pos = receive_pos_.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells_[pos & mask_];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (receive_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false; // Empty.
+                } else {
+                    pos = receive_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            out = std::move(cell->value);
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    // A handle to a channel: `val ch: channel[int] = channel(1024)`.
+    // `for msg in ch:` receives until the channel is closed and drained.
+    template<typename T>
+    class channel {
+    public:
+        explicit channel(int capacity = 1024)
+            : state_(std::make_shared<ChannelState<T>>(capacity > 0 ? static_cast<std::size_t>(capacity) : 1)) {}
+
+        ChannelState<T>* operator->() const { return state_.get(); }
+
+        class iterator {
+        public:
+            explicit iterator(ChannelState<T>* state) : state_(state) { advance(); }
+            const T& operator*() const { return value_; }
+            iterator& operator++() {
+                advance();
+                return *this;
+            }
+            bool operator!=(const iterator& other) const { return state_ != other.state_; }
+            bool operator==(const iterator& other) const { return state_ == other.state_; }
+
+        private:
+            ChannelState<T>* state_;
+            T value_{};
+
+            void advance() {
+                if (state_ && !state_->receive_into(value_)) {
+                    state_ = nullptr;
+                }
+            }
+        };
+
+        iterator begin() const { return iterator(state_.get()); }
+        iterator end() const { return iterator(nullptr); }
+
+    private:
+        std::shared_ptr<ChannelState<T>> state_;
+    };
+
+} // namespace rl
+
+#endif // RL_THREAD_HPP
@@ -7,6 +7,8 @@
 namespace rl {
 
     // Returns the current time as a Unix timestamp (seconds since epoch).
+    // This is wall-clock time: it can jump when the system clock is adjusted,
+    // so use now_ns() or a stopwatch to time code.
     inline double time() {
         return std::chrono::duration_cast<std::chrono::duration<double>>(
             std::chrono::system_clock::now().time_since_epoch()
@@ -18,6 +20,42 @@ namespace rl {
         std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
     }
 
+    namespace detail {
+        using steady = std::chrono::steady_clock;
+
+        // Counting from program start keeps the values small enough that a
+        // double holds every nanosecond exactly (for the first 104 days).
+        inline const steady::time_point program_start = steady::now();
+    }
+
+    // Nanoseconds since the program started, from the monotonic clock:
+    // never goes backwards, unaffected by clock adjustments.
+    inline double now_ns() {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(detail::steady::now() - detail::program_start).count());
+    }
+
+    // Measures elapsed time on the monotonic clock, from construction or the
+    // last reset():
+    //     val sw: stopwatch = stopwatch()
+    //     work()
+    //     print(sw.elapsed_ms())
+    class stopwatch {
+    public:
+        stopwatch() : start_(detail::steady::now()) {}
+
+        void reset() { start_ = detail::steady::now(); }
+
+        double elapsed() const { return std::chrono::duration<double>(detail::steady::now() - start_).count(); }
+        double elapsed_ms() const { return std::chrono::duration<double, std::milli>(detail::steady::now() - start_).count(); }
+        double elapsed_ns() const { return std::chrono::duration<double, std::nano>(detail::steady::now() - start_).count(); }
+
+        stopwatch* operator->() { return this; }
+        const stopwatch* operator->() const { return this; }
+
+    private:
+        detail::steady::time_point start_;
+    };
+
 } // namespace rl
 
 #endif // RL_TIME_HPP